@@ -0,0 +1,61 @@
+/* Command link from the game MCU (main.c) to the audio MCU (music.c).
+ *
+ * USCI B1 as a 3-pin SPI, game MCU master:
+ *   game P4.6 (UCB1SIMO, port mapped) -> audio P4.1 (UCB1SIMO)
+ *   game P4.7 (UCB1CLK, port mapped)  -> audio P4.3 (UCB1CLK)
+ * SMCLK / AUDIO_LINK_DIVIDER, so the audio MCU has that many cycles
+ * to take each byte in its receive interrupt.
+ *
+ * A frame is
+ *   AUDIO_SYNC, command, payload length, payload..., checksum
+ * where the checksum is the low byte of the sum of command, length
+ * and payload. Frames with a bad checksum are dropped.
+ */
+
+#define AUDIO_LINK_DIVIDER 16
+#define AUDIO_SYNC 0xA7
+
+#define AUDIO_PLAY_SONG 1   // song id
+#define AUDIO_PLAY_EFFECT 2 // song id, pitch in 16ths (16 = as written)
+#define AUDIO_STOP 3        // no payload, also forgets queued songs
+#define AUDIO_SET_TEMPO 4   // tempo in 16ths (16 = as written), 4..255
+#define AUDIO_UPLOAD 5      // up to AUDIO_UPLOAD_NOTES struct notes, step then ticks, low byte first
+
+// Song ids
+#define SONG_SCORE 0
+#define SONG_HIT 1
+#define SONG_INTRO 2
+#define SONG_GAME_OVER 3
+#define SONG_UPLOADED 4
+#define SONGS 5
+
+#define AUDIO_UPLOAD_NOTES 8
+#define AUDIO_MAX_PAYLOAD (4 * AUDIO_UPLOAD_NOTES)
+#define AUDIO_FRAME_SIZE (AUDIO_MAX_PAYLOAD + 4)
+
+/* Songs are arrays of struct note in flash (songs.h, generated by
+ * tools/song_table.c). A note is the phase step of a synthesizer voice
+ * on the audio MCU, worked out by the compiler, so playing a note never
+ * divides.
+ *   {NOTE_STEP(hz), NOTE_MS(ms)}        a note
+ *   {NOTE_REST, NOTE_MS(ms)}            a rest
+ *   {NOTE_REPEAT, NOTE_AGAIN(n, back)}  jump back over the last back
+ *                                       entries n more times (no nesting)
+ *   {0, 0}                              the end
+ */
+#define AUDIO_MCLK_HZ 15990784UL // audio MCU: FLL at 488 x 32768Hz
+#define SYNTH_PERIOD 1000        // MCLK cycles per sample, also the PWM period
+#define SYNTH_RATE (AUDIO_MCLK_HZ / SYNTH_PERIOD)
+#define SONG_TICK_HZ 16384 // Timer A1 on the audio MCU: ACLK / 2
+
+#define NOTE_REST 0
+#define NOTE_REPEAT 0xFFFF
+#define NOTE_STEP(hz) ((unsigned int)((hz) * 65536UL / SYNTH_RATE))
+#define NOTE_MS(ms) ((unsigned int)((ms) * (unsigned long)SONG_TICK_HZ / 1000))
+#define NOTE_AGAIN(n, back) (((n) << 8) | (back))
+
+struct note
+{
+    unsigned int step;  // phase added per sample, NOTE_REST or NOTE_REPEAT
+    unsigned int ticks; // Timer A1 ticks, 0 ends the song
+};
@@ -0,0 +1,254 @@
+/* Generated by tools/wav_clip.c, do not edit.
+ *
+ * Unsigned 8-bit samples at CLIP_RATE, the PWM duty out of 256.
+ */
+
+#define CLIP_RATE 8000
+
+// tools/clips/hit.wav, 960 samples (120 ms)
+#define HIT_CLIP_LENGTH 960
+const unsigned char hit_clip[HIT_CLIP_LENGTH] =
+{
+    102, 132, 157, 154, 162, 158, 226, 188, 255, 231, 231, 243, 199, 235, 213, 217,
+    189, 164, 189, 167, 147, 164, 121, 131, 102,  92,  82,  51,  44,  59,  47,  45,
+     33,  58,  36,  26,  60,  48,  54,  44,  49,  77,  75, 114, 105, 144, 163, 147,
+    174, 180, 171, 188, 198, 192, 209, 229, 217, 206, 226, 222, 195, 187, 166, 162,
+    153, 138, 134, 132, 118, 104,  91, 108,  81,  59,  60,  61,  56,  47,  44,  59,
+     61,  48,  57,  68,  61,  88,  94, 101,  97, 102, 110, 130, 146, 162, 163, 159,
+    166, 187, 190, 196, 190, 204, 199, 195, 195, 195, 191, 181, 168, 177, 162, 161,
+    145, 128, 135, 125, 115, 104,  92,  88,  80,  79,  72,  75,  71,  67,  63,  64,
+     68,  70,  79,  80,  89,  90,  96, 108, 116, 124, 129, 138, 143, 153, 160, 164,
+    171, 172, 173, 174, 179, 185, 181, 179, 184, 177, 172, 173, 161, 158, 150, 145,
+    140, 130, 127, 120, 118, 105, 101,  94,  94,  89,  85,  84,  77,  80,  80,  82,
+     81,  84,  86,  92,  92,  98, 101, 106, 113, 121, 125, 130, 135, 144, 147, 153,
+    158, 162, 163, 168, 169, 170, 169, 167, 168, 166, 165, 164, 158, 155, 150, 147,
+    143, 138, 131, 125, 122, 116, 111, 107, 102, 100,  98,  96,  94,  91,  91,  91,
+     90,  92,  94,  94,  98, 101, 104, 107, 109, 114, 119, 124, 128, 131, 137, 140,
+    144, 148, 150, 154, 157, 158, 159, 161, 160, 159, 160, 158, 156, 155, 153, 150,
+    146, 144, 141, 136, 133, 128, 125, 121, 117, 114, 111, 109, 106, 103, 101, 100,
+     99,  99,  98,  99, 100, 101, 102, 105, 106, 108, 111, 115, 117, 121, 124, 128,
+    131, 134, 137, 140, 143, 144, 147, 149, 150, 152, 152, 153, 153, 153, 152, 152,
+    149, 148, 146, 144, 142, 139, 136, 134, 131, 128, 125, 123, 120, 117, 115, 113,
+    111, 109, 108, 107, 106, 105, 105, 105, 106, 107, 108, 109, 110, 112, 114, 116,
+    118, 121, 123, 125, 128, 131, 133, 135, 137, 139, 141, 142, 144, 145, 146, 147,
+    147, 147, 147, 146, 146, 145, 144, 142, 141, 139, 137, 135, 133, 131, 129, 127,
+    125, 123, 121, 119, 117, 116, 114, 113, 112, 112, 111, 111, 110, 111, 111, 111,
+    112, 113, 114, 115, 117, 118, 120, 122, 124, 125, 127, 129, 131, 132, 134, 136,
+    137, 138, 139, 140, 141, 142, 142, 142, 142, 142, 142, 141, 141, 140, 139, 138,
+    137, 135, 134, 132, 131, 129, 128, 126, 125, 123, 122, 121, 119, 118, 117, 116,
+    116, 115, 115, 115, 115, 115, 115, 115, 116, 117, 117, 118, 119, 120, 122, 123,
+    124, 125, 127, 128, 129, 131, 132, 133, 134, 135, 136, 137, 137, 138, 138, 138,
+    139, 139, 139, 138, 138, 137, 137, 136, 135, 134, 133, 132, 131, 130, 129, 128,
+    127, 126, 125, 124, 123, 122, 121, 120, 120, 119, 119, 118, 118, 118, 118, 118,
+    118, 118, 119, 119, 120, 121, 121, 122, 123, 124, 125, 126, 127, 127, 128, 129,
+    130, 131, 132, 133, 133, 134, 134, 135, 135, 136, 136, 136, 136, 136, 136, 135,
+    135, 135, 134, 133, 133, 132, 132, 131, 130, 129, 128, 128, 127, 126, 125, 125,
+    124, 123, 123, 122, 122, 121, 121, 121, 121, 120, 120, 120, 121, 121, 121, 121,
+    122, 122, 123, 123, 124, 124, 125, 126, 126, 127, 128, 128, 129, 129, 130, 131,
+    131, 132, 132, 133, 133, 133, 133, 133, 134, 134, 134, 133, 133, 133, 133, 133,
+    132, 132, 131, 131, 130, 130, 129, 129, 128, 128, 127, 127, 126, 126, 125, 125,
+    124, 124, 123, 123, 123, 123, 122, 122, 122, 122, 122, 122, 123, 123, 123, 123,
+    123, 124, 124, 125, 125, 125, 126, 126, 127, 127, 128, 128, 129, 129, 129, 130,
+    130, 131, 131, 131, 131, 132, 132, 132, 132, 132, 132, 132, 132, 132, 131, 131,
+    131, 131, 131, 130, 130, 130, 129, 129, 128, 128, 128, 127, 127, 127, 126, 126,
+    126, 125, 125, 125, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124,
+    124, 124, 125, 125, 125, 125, 126, 126, 126, 126, 127, 127, 127, 128, 128, 128,
+    129, 129, 129, 129, 130, 130, 130, 130, 130, 130, 131, 131, 131, 131, 131, 131,
+    131, 130, 130, 130, 130, 130, 130, 129, 129, 129, 129, 128, 128, 128, 128, 127,
+    127, 127, 127, 126, 126, 126, 126, 126, 125, 125, 125, 125, 125, 125, 125, 125,
+    125, 125, 125, 125, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 127, 127,
+    127, 127, 127, 128, 128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, 130,
+    130, 130, 130, 130, 130, 130, 130, 130, 130, 130, 129, 129, 129, 129, 129, 129,
+    129, 129, 128, 128, 128, 128, 128, 128, 127, 127, 127, 127, 127, 127, 126, 126,
+    126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126,
+    126, 126, 126, 126, 126, 126, 127, 127, 127, 127, 127, 127, 127, 127, 128, 128,
+    128, 128, 128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129,
+    129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+    126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126,
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 129,
+    129, 129, 129, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+};
+
+// tools/clips/score.wav, 2800 samples (350 ms)
+#define SCORE_CLIP_LENGTH 2800
+const unsigned char score_clip[SCORE_CLIP_LENGTH] =
+{
+    159, 229, 208, 209, 177,  61,  11,  53,  68, 112, 223, 248, 186, 160, 109,  12,
+     13,  93, 125, 175, 254, 226, 133, 101,  58,   0,  54, 154, 180, 210, 245, 169,
+     70,  57,  41,  29, 120, 213, 209, 207, 200,  99,  21,  45,  63,  85, 188, 247,
+    201, 170, 138,  40,   5,  72, 112, 148, 234, 243, 158, 114,  82,  12,  29, 127,
+    168, 192, 242, 201,  96,  65,  53,  23,  85, 189, 206, 203, 213, 137,  39,  41,
+     61,  67, 152, 236, 212, 178, 159,  73,   8,  54, 100, 125, 206, 249, 182, 128,
+    103,  32,  14,  99, 154, 175, 230, 224, 126,  75,  65,  27,  56, 160, 200, 197,
+    217, 170,  65,  41,  60,  56, 117, 215, 219, 184, 175, 107,  21,  40,  89, 107,
+    176, 244, 203, 142, 121,  57,  11,  73, 139, 159, 212, 236, 156,  89,  77,  37,
+     36, 129, 190, 190, 214, 195,  96,  47,  61,  53,  88, 188, 220, 189, 184, 137,
+     43,  31,  78,  95, 146, 229, 218, 157, 135,  84,  17,  51, 122, 145, 191, 238,
+    183, 107,  88,  53,  26,  98, 174, 183, 206, 212, 128,  58,  63,  55,  66, 157,
+    214, 193, 188, 163,  71,  31,  69,  86, 120, 206, 226, 172, 146, 109,  33,  35,
+    103, 133, 168, 229, 205, 127,  99,  70,  27,  71, 154, 175, 194, 219, 158,  76,
+     66,  60,  52, 125, 201, 196, 188, 181, 102,  38,  60,  81,  99, 179, 226, 186,
+    155, 131,  56,  28,  85, 122, 148, 213, 220, 148, 110,  87,  36,  50, 131, 166,
+    181, 217, 184,  98,  71,  67,  47,  96, 182, 195, 186, 192, 132,  53,  55,  77,
+     84, 150, 217, 197, 163, 148,  81,  30,  69, 111, 131, 192, 225, 169, 122, 103,
+     51,  37, 108, 155, 169, 209, 203, 122,  80,  75,  49,  73, 158, 191, 183, 196,
+    158,  73,  54,  75,  75, 123, 201, 204, 170, 160, 108,  40,  56, 101, 117, 169,
+    222, 187, 134, 117,  70,  34,  85, 142, 157, 195, 213, 148,  91,  83,  57,  57,
+    132, 183, 180, 194, 179,  98,  58,  74,  72,  99, 179, 205, 176, 167, 132,  57,
+     48,  91, 107, 146, 210, 201, 148, 128,  90,  39,  66, 128, 147, 179, 215, 171,
+    106,  91,  68,  48, 106, 170, 176, 188, 192, 125,  67,  73,  72,  82, 154, 201,
+    181, 172, 152,  80,  47,  81,  99, 125, 193, 208, 161, 137, 109,  51,  53, 112,
+    137, 163, 209, 189, 123,  99,  80,  48,  84, 153, 170, 181, 198, 150,  82,  75,
+     75,  71, 128, 190, 184, 173, 166, 104,  52,  73,  94, 109, 171, 209, 174, 145,
+    126,  68,  47,  95, 128, 148, 197, 201, 141, 108,  93,  55,  67, 134, 164, 172,
+    198, 171, 100,  78,  79,  66, 105, 175, 185, 173, 175, 128,  64,  67,  90,  97,
+    148, 202, 184, 152, 139,  89,  48,  81, 119, 134, 180, 206, 159, 118, 104,  66,
+     56, 114, 155, 163, 191, 186, 120,  84,  84,  67,  86, 155, 182, 173, 179, 149,
+     81,  66,  87,  90, 126, 189, 190, 159, 149, 109,  56,  69, 110, 124, 162, 204,
+    175, 129, 114,  80,  53,  95, 144, 155, 182, 195, 141,  94,  89,  72,  73, 134,
+    176, 171, 178, 166, 101,  68,  84,  86, 108, 171, 192, 165, 155, 128,  69,  62,
+    100, 116, 145, 195, 187, 141, 123,  96,  56,  79, 131, 147, 170, 197, 161, 106,
+     95,  80,  66, 113, 165, 169, 175, 177, 123,  76,  82,  86,  94, 151, 189, 171,
+    159, 144,  87,  61,  91, 109, 129, 181, 193, 153, 130, 110,  66,  68, 117, 140,
+    158, 192, 176, 121, 101,  89,  65,  94, 152, 165, 170, 182, 143,  87,  82,  87,
+     85, 131, 181, 175, 162, 155, 107,  65,  83, 104, 116, 164, 194, 164, 137, 123,
+     79,  62, 103, 133, 146, 183, 186, 136, 108,  98,  70,  80, 136, 160, 164, 182,
+    160, 102,  85,  89,  81, 112, 168, 176, 163, 162, 126,  74,  78, 100, 107, 146,
+    189, 173, 144, 133,  95,  63,  91, 125, 137, 171, 191, 152, 116, 106,  78,  71,
+    119, 153, 158, 178, 173, 119,  89,  92,  81,  96, 152, 175, 164, 166, 143,  88,
+     76,  96, 101, 129, 179, 179, 151, 141, 111,  69,  81, 116, 128, 157, 189, 165,
+    125, 113,  89,  68, 103, 144, 153, 171, 180, 137,  97,  95,  84,  86, 135, 170,
+    164, 166, 156, 105,  77,  92,  97, 114, 164, 181, 157, 146, 125,  80,  74, 107,
+    122, 143, 182, 175, 135, 120, 101,  71,  89, 134, 147, 162, 182, 153, 107,  98,
+     90,  80, 117, 161, 163, 164, 165, 122,  83,  90,  96, 103, 148, 179, 163, 150,
+    138,  94,  73,  99, 116, 131, 171, 181, 146, 126, 111,  78,  80, 122, 141, 153,
+    179, 165, 119, 103,  96,  79, 102, 150, 161, 161, 169, 138,  93,  89,  96,  96,
+    132, 173, 167, 153, 147, 109,  76,  92, 111, 121, 158, 182, 156, 132, 121,  88,
+     75, 110, 135, 145, 172, 174, 133, 108, 102,  82,  91, 136, 157, 158, 169, 152,
+    105,  90,  97,  93, 117, 162, 168, 155, 153, 124,  83,  87, 107, 114, 144, 178,
+    164, 138, 129, 100,  75,  99, 128, 138, 163, 178, 146, 115, 108,  88,  83, 122,
+    151, 154, 167, 162, 119,  94,  98,  92, 104, 149, 168, 156, 156, 138,  94,  84,
+    103, 109, 131, 170, 170, 144, 135, 113,  80,  90, 121, 131, 152, 177, 157, 123,
+    113,  96,  81, 109, 144, 150, 162, 168, 133, 100, 100,  94,  96, 135, 164, 157,
+    156, 148, 107,  85,  99, 106, 119, 158, 172, 150, 140, 124,  88,  84, 113, 126,
+    142, 172, 166, 132, 118, 105,  82,  98, 135, 146, 156, 170, 146, 109, 102,  98,
+     91, 121, 157, 157, 156, 155, 121,  90,  97, 104, 110, 146, 170, 156, 143, 133,
+    171, 219, 208, 107,  18,  65, 128, 250, 183, 134,   9,  63, 130, 228, 213, 109,
+     48,  23, 157, 196, 238, 102,  55,  27, 135, 216, 210, 143,  23,  58,  98, 236,
+    197, 155,  31,  42, 114, 203, 233, 126,  70,  10, 133, 181, 242, 134,  63,  29,
+     99, 209, 208, 174,  36,  54,  75, 213, 209, 170,  60,  27, 101, 174, 244, 144,
+     92,   7, 107, 167, 236, 166,  73,  38,  68, 195, 204, 199,  58,  51,  59, 184,
+    217, 181,  92,  20,  88, 146, 245, 163, 112,  15,  80, 153, 223, 195,  87,  50,
+     44, 176, 197, 215,  85,  51,  51, 151, 220, 188, 124,  21,  77, 121, 236, 182,
+    130,  32,  57, 139, 204, 217, 104,  65,  28, 152, 189, 222, 116,  53,  48, 119,
+    217, 192, 152,  31,  67, 100, 218, 199, 144,  55,  38, 125, 182, 231, 123,  81,
+     23, 125, 181, 221, 147,  60,  51,  89, 207, 194, 175,  49,  58,  85, 193, 212,
+    156,  81,  27, 110, 160, 235, 144,  95,  26,  98, 171, 213, 176,  71,  57,  65,
+    190, 194, 191,  73,  52,  74, 164, 219, 166, 108,  24,  95, 140, 230, 166, 109,
+     38,  73, 159, 200, 199,  86,  65,  49, 168, 193, 200, 101,  49,  69, 135, 220,
+    175, 133,  30,  81, 122, 217, 186, 122,  55,  52, 146, 185, 215, 105,  74,  40,
+    142, 189, 203, 131,  52,  66, 108, 213, 182, 153,  44,  67, 108, 197, 202, 134,
+     75,  38, 130, 170, 222, 127,  83,  40, 114, 183, 200, 158,  59,  66,  85, 199,
+    188, 169,  65,  57,  97, 173, 213, 146,  96,  32, 113, 154, 221, 150,  93,  47,
+     89, 174, 194, 181,  73,  68,  69, 179, 192, 179,  90,  50,  89, 148, 217, 157,
+    117,  34,  96, 140, 212, 172, 104,  58,  67, 162, 185, 198,  91,  71,  59, 155,
+    193, 184, 117,  49,  83, 125, 214, 169, 134,  45,  79, 128, 197, 191, 115,  73,
+     51, 147, 175, 207, 112,  76,  56, 129, 191, 186, 142,  53,  78, 104, 203, 179,
+    148,  62,  65, 117, 178, 204, 127,  89,  43, 129, 165, 209, 135,  82,  58, 104,
+    185, 185, 164,  64,  75,  89, 186, 187, 159,  83,  55, 108, 158, 211, 141, 104,
+     42, 110, 155, 204, 158,  89,  65,  82, 175, 181, 180,  80,  73,  78, 165, 193,
+    166, 105,  50,  99, 138, 211, 155, 118,  49,  91, 145, 193, 178,  99,  74,  66,
+    160, 177, 191, 100,  72,  73, 141, 194, 171, 128,  52,  91, 121, 203, 168, 130,
+     62,  75, 135, 180, 193, 112,  85,  56, 143, 171, 195, 123,  75,  72, 118, 191,
+    174, 147,  60,  83, 107, 189, 180, 140,  79,  62, 125, 164, 202, 126,  95,  53,
+    123, 165, 193, 145,  79,  74,  97, 183, 175, 163,  73,  77,  96, 171, 189, 149,
+     97,  55, 114, 149, 204, 142, 106,  56, 104, 158, 187, 165,  88,  78,  81, 170,
+    175, 174,  91,  73,  89, 151, 194, 156, 116,  54, 103, 135, 200, 157, 115,  65,
+     86, 149, 178, 181,  99,  84,  70, 154, 174, 180, 112,  71,  86, 130, 193, 162,
+    133,  59,  93, 123, 189, 171, 124,  78,  72, 139, 167, 191, 113,  90,  65, 135,
+    172, 181, 133,  73,  84, 111, 188, 167, 147,  70,  83, 113, 175, 183, 133,  92,
+     62, 128, 156, 195, 129,  97,  66, 115, 167, 179, 152,  80,  84,  96, 177, 171,
+    158,  85,  76, 105, 157, 190, 141, 107,  59, 116, 145, 193, 146, 104,  71,  97,
+    160, 174, 168,  90,  85,  85, 162, 174, 165, 104,  72, 100, 140, 192, 150, 121,
+     62, 103, 136, 186, 162, 111,  80,  82, 151, 167, 179, 103,  88,  79, 144, 175,
+    168, 122,  71,  95, 123, 189, 158, 133,  70,  91, 127, 175, 175, 119,  90,  72,
+    140, 160, 185, 119,  91,  77, 126, 173, 169, 140,  75,  92, 109, 180, 165, 143,
+     83,  81, 120, 161, 184, 128, 101,  67, 127, 153, 185, 136,  95,  79, 108, 168,
+    168, 155,  83,  89,  99, 167, 171, 150,  98,  75, 113, 147, 188, 138, 112,  67,
+    113, 146, 181, 152, 101,  84,  93, 160, 165, 166,  95,  88,  92, 152, 175, 155,
+    114,  72, 106, 133, 187, 148, 122,  73, 100, 139, 173, 165, 108,  90,  82, 149,
+    162, 173, 110,  88,  88, 135, 175, 158, 130,  74, 100, 121, 180, 158, 130,  82,
+     88, 132, 163, 176, 117,  98,  76, 137, 158, 175, 126,  90,  88, 118, 173, 160,
+    143,  80,  95, 112, 170, 166, 137,  95,  80, 125, 152, 181, 128, 105,  74, 122,
+    154, 174, 142,  94,  90, 104, 166, 161, 154,  90,  91, 105, 157, 172, 143, 108,
+     75, 117, 141, 182, 139, 113,  78, 108, 149, 169, 156, 100,  93,  93, 157, 162,
+    161, 104,  88, 100, 142, 175, 148, 121,  75, 109, 132, 178, 150, 119,  84,  96,
+    143, 162, 167, 108,  97,  86, 144, 161, 165, 119,  87,  98, 127, 174, 152, 133,
+     80, 102, 123, 170, 160, 126,  94,  86, 135, 155, 174, 119, 101,  83, 131, 159,
+    165, 133,  89,  97, 114, 170, 156, 143,  88,  95, 117, 159, 168, 132, 104,  80,
+    127, 147, 176, 131, 106,  84, 117, 156, 163, 147,  94,  97, 104, 161, 159, 150,
+     99,  90, 111, 147, 173, 138, 115,  79, 118, 140, 174, 142, 111,  88, 104, 151,
+    160, 158, 102,  98,  96, 150, 161, 154, 112,  87, 107, 134, 174, 144, 124,  81,
+    109, 133, 168, 153, 116,  94,  94, 144, 155, 165, 111,  99,  92, 138, 161, 156,
+    126,  87, 104, 123, 171, 150, 133,  88, 100, 127, 160, 162, 122, 102,  87, 135,
+    150, 168, 123, 101,  92, 124, 160, 157, 138,  91, 102, 113, 164, 155, 139,  97,
+     93, 122, 150, 168, 129, 110,  84, 126, 145, 168, 135, 105,  93, 112, 156, 156,
+    148,  97, 100, 106, 154, 159, 144, 108,  89, 117, 140, 171, 136, 117,  85, 116,
+    141, 165, 146, 109,  97, 102, 150, 154, 156, 106,  99, 102, 143, 162, 147, 120,
+     88, 112, 130, 169, 143, 124,  89, 106, 136, 159, 156, 114, 102,  94, 142, 152,
+    160, 117,  99, 100, 131, 162, 150, 131,  89, 108, 122, 164, 150, 130,  96,  98,
+    130, 152, 163, 121, 107,  90, 133, 149, 161, 128, 101, 100, 119, 159, 151, 140,
+     94, 104, 116, 157, 156, 135, 105,  93, 125, 144, 166, 129, 112,  90, 122, 146,
+    160, 139, 104, 101, 110, 155, 152, 147, 102, 101, 111, 147, 160, 139, 115,  90,
+    119, 136, 166, 137, 117,  93, 112, 142, 156, 149, 108, 103, 102, 147, 152, 152,
+    112,  99, 108, 136, 162, 142, 124,  90, 114, 130, 163, 145, 122,  98, 104, 138,
+    152, 156, 115, 106,  98, 138, 151, 154, 123,  99, 106, 126, 161, 145, 132,  94,
+    108, 124, 157, 152, 127, 104,  97, 132, 146, 161, 122, 109,  96, 128, 150, 154,
+    133, 100, 106, 117, 157, 148, 139, 100, 104, 119, 149, 157, 131, 112,  93, 126,
+    141, 162, 131, 112,  97, 118, 147, 153, 142, 104, 106, 110, 151, 150, 144, 109,
+    100, 116, 140, 160, 135, 119,  93, 120, 136, 160, 139, 116, 100, 110, 144, 150,
+    150, 110, 106, 105, 143, 152, 147, 118,  98, 113, 131, 160, 140, 126,  95, 113,
+    131, 156, 147, 120, 105, 103, 138, 147, 155, 117, 107, 102, 133, 152, 148, 128,
+     99, 111, 123, 158, 144, 132, 100, 107, 127, 150, 153, 124, 110,  98, 132, 143,
+    157, 125, 109, 102, 124, 151, 148, 136, 102, 109, 117, 153, 148, 136, 107, 103,
+    123, 143, 157, 129, 116,  96, 125, 140, 156, 134, 111, 104, 115, 148, 148, 143,
+    106, 108, 112, 146, 151, 139, 115, 100, 119, 135, 158, 134, 121,  97, 118, 137,
+    153, 142, 114, 106, 108, 143, 146, 148, 113, 107, 109, 137, 152, 142, 123,  99,
+    116, 129, 157, 140, 126, 101, 111, 133, 149, 149, 119, 110, 103, 137, 145, 151,
+    121, 107, 108, 129, 152, 143, 131, 101, 113, 123, 153, 144, 129, 106, 106, 129,
+    144, 153, 123, 113, 101, 130, 143, 151, 129, 108, 108, 121, 150, 144, 137, 105,
+    110, 119, 147, 148, 133, 113, 102, 125, 138, 155, 129, 117, 101, 123, 141, 150,
+    137, 111, 109, 114, 146, 145, 142, 110, 108, 116, 140, 151, 136, 120, 100, 121,
+    133, 155, 135, 121, 103, 116, 138, 148, 144, 114, 110, 109, 141, 145, 145, 118,
+    107, 114, 133, 152, 138, 126, 101, 117, 129, 152, 141, 124, 107, 110, 135, 144,
+    149, 119, 112, 106, 134, 145, 146, 125, 107, 112, 125, 151, 141, 132, 104, 113,
+    125, 148, 146, 127, 112, 105, 131, 140, 151, 125, 115, 105, 127, 143, 146, 133,
+    108, 112, 119, 148, 142, 136, 109, 110, 122, 142, 149, 130, 117, 103, 126, 136,
+    152, 131, 117, 106, 120, 142, 145, 139, 111, 112, 114, 143, 144, 139, 115, 108,
+    119, 136, 151, 133, 122, 103, 121, 133, 150, 137, 119, 108, 114, 139, 143, 144,
+    115, 112, 111, 137, 145, 141, 122, 107, 117, 129, 151, 137, 127, 105, 117, 130,
+    147, 142, 122, 112, 109, 135, 141, 147, 121, 113, 110, 131, 145, 142, 129, 107,
+    115, 124, 149, 140, 131, 108, 112, 127, 143, 146, 125, 116, 106, 130, 139, 148,
+    127, 114, 110, 124, 144, 142, 135, 109, 114, 119, 145, 142, 134, 114, 109, 124,
+    138, 149, 129, 120, 105, 125, 136, 148, 133, 116, 111, 118, 142, 142, 139, 113,
+    113, 116, 140, 144, 136, 119, 107, 122, 133, 150, 133, 123, 106, 120, 134, 146,
+    139, 118, 113, 113, 138, 141, 143, 118, 113, 114, 134, 145, 138, 125, 107, 119,
+    128, 148, 137, 126, 109, 115, 131, 142, 143, 121, 115, 110, 134, 140, 144, 124,
+    113, 114, 127, 145, 139, 130, 109, 117, 124, 145, 140, 129, 113, 112, 129, 139,
+    146, 125, 118, 108, 129, 138, 144, 130, 114, 114, 122, 143, 139, 135, 112, 115,
+    121, 141, 143, 131, 118, 109, 126, 135, 147, 129, 120, 109, 123, 137, 143, 135,
+    116, 114, 117, 140, 140, 138, 116, 113, 119, 136, 145, 134, 123, 108, 123, 131,
+    147, 133, 123, 110, 118, 135, 141, 140, 118, 116, 114, 136, 140, 140, 121, 113,
+    118, 130, 145, 135, 127, 109, 120, 128, 145, 137, 125, 113, 114, 132, 139, 143,
+    122, 117, 112, 132, 140, 141, 127, 113, 117, 125, 144, 137, 131, 111, 117, 125,
+    141, 141, 127, 117, 111, 129, 136, 145, 126, 118, 112, 126, 139, 141, 132, 114,
+    116, 121, 142, 138, 134, 115, 115, 123, 137, 143, 130, 121, 110, 126, 134, 145,
+    130, 120, 112, 121, 137, 140, 136, 116, 116, 118, 138, 139, 136, 119, 113, 121,
+    133, 144, 132, 124, 110, 123, 131, 143, 135, 122, 114, 117, 135, 139, 140, 119,
+    117, 116, 134, 140, 137, 124, 112, 120, 128, 144, 134, 127, 112, 119, 129, 141,
+    139, 124, 117, 114, 132, 137, 142, 123, 117, 115, 129, 140, 138, 129, 113, 119,
+    124, 142, 136, 130, 114, 116, 127, 138, 141, 126, 119, 112, 129, 135, 142, 128,
+};
+
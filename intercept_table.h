@@ -0,0 +1,263 @@
+/* Generated by tools/gen_intercept.c, do not edit.
+ *
+ * intercept_frames[|x_vel| - 1][dist] is the number of move_ball()
+ * calls before the ball covers dist pixels.
+ *
+ * intercept_path[intercept_start[y_vel - 1][y - INTERCEPT_Y_MIN] + frames]
+ * is the ball's y after that many frames, for y_vel > 0. Negative
+ * velocities use the mirror image: 59 - lookup(59 - y, -y_vel).
+ *
+ * Starts with INTERCEPT_TWO_CYCLE set are balls stuck flipping
+ * outside a wall; their path has two entries picked by frames & 1.
+ */
+
+#define INTERCEPT_SPAN 59
+#define INTERCEPT_Y_MIN -11
+#define INTERCEPT_Y_MAX 70
+#define INTERCEPT_Y_COUNT 82
+#define INTERCEPT_MAX_Y_SPEED 6
+#define INTERCEPT_MAX_X_SPEED 5
+#define INTERCEPT_MAX_DIST 64
+#define INTERCEPT_PATH_LEN 2226
+#define INTERCEPT_TWO_CYCLE 0x8000
+
+const unsigned char intercept_frames[INTERCEPT_MAX_X_SPEED][INTERCEPT_MAX_DIST + 1] =
+{
+  {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64,
+  },
+  {
+     0,  1,  1,  2,  2,  3,  3,  4,  4,  5,  5,  6,  6,  7,  7,  8,
+     8,  9,  9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15, 16,
+    16, 17, 17, 18, 18, 19, 19, 20, 20, 21, 21, 22, 22, 23, 23, 24,
+    24, 25, 25, 26, 26, 27, 27, 28, 28, 29, 29, 30, 30, 31, 31, 32,
+    32,
+  },
+  {
+     0,  1,  1,  1,  2,  2,  2,  3,  3,  3,  4,  4,  4,  5,  5,  5,
+     6,  6,  6,  7,  7,  7,  8,  8,  8,  9,  9,  9, 10, 10, 10, 11,
+    11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15, 16, 16,
+    16, 17, 17, 17, 18, 18, 18, 19, 19, 19, 20, 20, 20, 21, 21, 21,
+    22,
+  },
+  {
+     0,  1,  1,  1,  1,  2,  2,  2,  2,  3,  3,  3,  3,  4,  4,  4,
+     4,  5,  5,  5,  5,  6,  6,  6,  6,  7,  7,  7,  7,  8,  8,  8,
+     8,  9,  9,  9,  9, 10, 10, 10, 10, 11, 11, 11, 11, 12, 12, 12,
+    12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15, 16, 16, 16,
+    16,
+  },
+  {
+     0,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,
+     4,  4,  4,  4,  4,  5,  5,  5,  5,  5,  6,  6,  6,  6,  6,  7,
+     7,  7,  7,  7,  8,  8,  8,  8,  8,  9,  9,  9,  9,  9, 10, 10,
+    10, 10, 10, 11, 11, 11, 11, 11, 12, 12, 12, 12, 12, 13, 13, 13,
+    13,
+  },
+};
+
+const unsigned int intercept_start[INTERCEPT_MAX_Y_SPEED][INTERCEPT_Y_COUNT] =
+{
+  {
+        0,     0,     0,     0,     0,     0, 32768, 32770, 32772, 32774, 32776, 32778,
+       12,    13,    14,    15,    16,    17,    18,    19,    20,    21,    22,    23,
+       24,    25,    26,    27,    28,    29,    30,    31,    32,    33,    34,    35,
+       36,    37,    38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
+       48,    49,    50,    51,    52,    53,    54,    55,    56,    57,    58,    59,
+       60,    61,    62,    63,    64,    65,    66,    67,    68,    69,    70, 32962,
+    32964, 32966, 32968, 32970, 32972,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0, 32974, 32976, 32978, 32980, 32982, 32984,
+      218,   342,   219,   343,   220,   344,   221,   345,   222,   346,   223,   347,
+      224,   348,   225,   349,   226,   350,   227,   351,   228,   352,   229,   353,
+      230,   354,   231,   355,   232,   356,   233,   357,   234,   358,   235,   359,
+      236,   360,   237,   361,   238,   362,   239,   363,   240,   364,   241,   365,
+      242,   366,   243,   367,   244,   368,   245,   369,   246,   370,   247,   371,
+    33234, 33236, 33238, 33240, 33242, 33244,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0, 33246, 33248, 33250, 33252, 33254, 33256,
+      490,   596,   700,   491,   597,   701,   492,   598,   702,   493,   599,   703,
+      494,   600,   704,   495,   601,   705,   496,   602,   706,   497,   603,   707,
+      498,   604,   708,   499,   605,   709,   500,   606,   710,   501,   607,   711,
+      502,   608,   712,   503,   609,   713,   504,   610,   714,   505,   611,   715,
+      506,   612,   716,   507,   613,   717,   508,   614,   718,   509,   615,   719,
+      510, 33572, 33574, 33576, 33578, 33580, 33582,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0, 33584, 33586, 33588, 33590, 33592, 33594,
+      828,   924,  1020,  1114,   829,   925,  1021,  1115,   830,   926,  1022,  1116,
+      831,   927,  1023,  1117,   832,   928,  1024,  1118,   833,   929,  1025,  1119,
+      834,   930,  1026,  1120,   835,   931,  1027,  1121,   836,   932,  1028,  1122,
+      837,   933,  1029,  1123,   838,   934,  1030,  1124,   839,   935,  1031,  1125,
+      840,   936,  1032,  1126,   841,   937,  1033,  1127,   842,   938,  1034,  1128,
+      843,   939, 33976, 33978, 33980, 33982, 33984, 33986,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0, 33988, 33990, 33992, 33994, 33996, 33998,
+     1232,  1322,  1412,  1502,  1590,  1233,  1323,  1413,  1503,  1591,  1234,  1324,
+     1414,  1504,  1592,  1235,  1325,  1415,  1505,  1593,  1236,  1326,  1416,  1506,
+     1594,  1237,  1327,  1417,  1507,  1595,  1238,  1328,  1418,  1508,  1596,  1239,
+     1329,  1419,  1509,  1597,  1240,  1330,  1420,  1510,  1598,  1241,  1331,  1421,
+     1511,  1599,  1242,  1332,  1422,  1512,  1600,  1243,  1333,  1423,  1513,  1601,
+     1244,  1334,  1424, 34446, 34448, 34450, 34452, 34454, 34456,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0, 34458, 34460, 34462, 34464, 34466, 34468,
+     1702,  1788,  1874,  1960,  2046,  2130,  1703,  1789,  1875,  1961,  2047,  2131,
+     1704,  1790,  1876,  1962,  2048,  2132,  1705,  1791,  1877,  1963,  2049,  2133,
+     1706,  1792,  1878,  1964,  2050,  2134,  1707,  1793,  1879,  1965,  2051,  2135,
+     1708,  1794,  1880,  1966,  2052,  2136,  1709,  1795,  1881,  1967,  2053,  2137,
+     1710,  1796,  1882,  1968,  2054,  2138,  1711,  1797,  1883,  1969,  2055,  2139,
+     1712,  1798,  1884,  1970, 34982, 34984, 34986, 34988, 34990, 34992,
+  },
+};
+
+const signed char intercept_path[INTERCEPT_PATH_LEN] =
+{
+    -5, -6, -4, -5, -3, -4, -2, -3, -1, -2,  0, -1,  1,  2,  3,  4,
+     5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+    21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+    37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
+    53, 54, 55, 56, 57, 58, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50,
+    49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34,
+    33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18,
+    17, 16, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,
+     1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30,
+    31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 58, 57, 56,
+    55, 54, 60, 59, 61, 60, 62, 61, 63, 62, 64, 63, 65, 64, -5, -7,
+    -4, -6, -3, -5, -2, -4, -1, -3,  0, -2,  1,  3,  5,  7,  9, 11,
+    13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 39, 41, 43,
+    45, 47, 49, 51, 53, 55, 57, 59, 57, 55, 53, 51, 49, 47, 45, 43,
+    41, 39, 37, 35, 33, 31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11,
+     9,  7,  5,  3,  1, -1,  1,  3,  5,  7,  9, 11, 13, 15, 17, 19,
+    21, 23, 25, 27, 29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51,
+    53, 55, 57, 59, 57, 55, 53, 51, 49, 47, 45, 43, 41, 39, 37, 35,
+    33, 31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11,  9,  7,  5,  3,
+     1, -1,  1,  3,  5,  7,  2,  4,  6,  8, 10, 12, 14, 16, 18, 20,
+    22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52,
+    54, 56, 58, 60, 58, 56, 54, 52, 50, 48, 46, 44, 42, 40, 38, 36,
+    34, 32, 30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10,  8,  6,  4,
+     2,  0,  2,  4,  6,  8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28,
+    30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60,
+    58, 56, 54, 52, 50, 48, 46, 44, 42, 40, 38, 36, 34, 32, 30, 28,
+    26, 24, 22, 20, 18, 16, 14, 12, 10,  8,  6,  4,  2,  0,  2,  4,
+     6,  8, 61, 59, 62, 60, 63, 61, 64, 62, 65, 63, 66, 64, -5, -8,
+    -4, -7, -3, -6, -2, -5, -1, -4,  0, -3,  1,  4,  7, 10, 13, 16,
+    19, 22, 25, 28, 31, 34, 37, 40, 43, 46, 49, 52, 55, 58, 61, 58,
+    55, 52, 49, 46, 43, 40, 37, 34, 31, 28, 25, 22, 19, 16, 13, 10,
+     7,  4,  1, -2,  1,  4,  7, 10, 13, 16, 19, 22, 25, 28, 31, 34,
+    37, 40, 43, 46, 49, 52, 55, 58, 61, 58, 55, 52, 49, 46, 43, 40,
+    37, 34, 31, 28, 25, 22, 19, 16, 13, 10,  7,  4,  1, -2,  1,  4,
+     7, 10, 13, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46, 49, 52,
+    55, 58, 61, 58,  2,  5,  8, 11, 14, 17, 20, 23, 26, 29, 32, 35,
+    38, 41, 44, 47, 50, 53, 56, 59, 56, 53, 50, 47, 44, 41, 38, 35,
+    32, 29, 26, 23, 20, 17, 14, 11,  8,  5,  2, -1,  2,  5,  8, 11,
+    14, 17, 20, 23, 26, 29, 32, 35, 38, 41, 44, 47, 50, 53, 56, 59,
+    56, 53, 50, 47, 44, 41, 38, 35, 32, 29, 26, 23, 20, 17, 14, 11,
+     8,  5,  2, -1,  2,  5,  8, 11, 14, 17, 20, 23, 26, 29, 32, 35,
+    38, 41, 44, 47, 50, 53, 56, 59, 56, 53, 50, 47,  3,  6,  9, 12,
+    15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45, 48, 51, 54, 57, 60,
+    57, 54, 51, 48, 45, 42, 39, 36, 33, 30, 27, 24, 21, 18, 15, 12,
+     9,  6,  3,  0,  3,  6,  9, 12, 15, 18, 21, 24, 27, 30, 33, 36,
+    39, 42, 45, 48, 51, 54, 57, 60, 57, 54, 51, 48, 45, 42, 39, 36,
+    33, 30, 27, 24, 21, 18, 15, 12,  9,  6,  3,  0,  3,  6,  9, 12,
+    15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45, 48, 51, 54, 57, 60,
+    57, 54, 51, 48, 62, 59, 63, 60, 64, 61, 65, 62, 66, 63, 67, 64,
+    -5, -9, -4, -8, -3, -7, -2, -6, -1, -5,  0, -4,  1,  5,  9, 13,
+    17, 21, 25, 29, 33, 37, 41, 45, 49, 53, 57, 61, 57, 53, 49, 45,
+    41, 37, 33, 29, 25, 21, 17, 13,  9,  5,  1, -3,  1,  5,  9, 13,
+    17, 21, 25, 29, 33, 37, 41, 45, 49, 53, 57, 61, 57, 53, 49, 45,
+    41, 37, 33, 29, 25, 21, 17, 13,  9,  5,  1, -3,  1,  5,  9, 13,
+    17, 21, 25, 29, 33, 37, 41, 45, 49, 53, 57, 61, 57, 53, 49, 45,
+    41, 37, 33, 29, 25, 21, 17, 13,  9,  5,  1, -3,  2,  6, 10, 14,
+    18, 22, 26, 30, 34, 38, 42, 46, 50, 54, 58, 62, 58, 54, 50, 46,
+    42, 38, 34, 30, 26, 22, 18, 14, 10,  6,  2, -2,  2,  6, 10, 14,
+    18, 22, 26, 30, 34, 38, 42, 46, 50, 54, 58, 62, 58, 54, 50, 46,
+    42, 38, 34, 30, 26, 22, 18, 14, 10,  6,  2, -2,  2,  6, 10, 14,
+    18, 22, 26, 30, 34, 38, 42, 46, 50, 54, 58, 62, 58, 54, 50, 46,
+    42, 38, 34, 30, 26, 22, 18, 14, 10,  6,  2, -2,  3,  7, 11, 15,
+    19, 23, 27, 31, 35, 39, 43, 47, 51, 55, 59, 55, 51, 47, 43, 39,
+    35, 31, 27, 23, 19, 15, 11,  7,  3, -1,  3,  7, 11, 15, 19, 23,
+    27, 31, 35, 39, 43, 47, 51, 55, 59, 55, 51, 47, 43, 39, 35, 31,
+    27, 23, 19, 15, 11,  7,  3, -1,  3,  7, 11, 15, 19, 23, 27, 31,
+    35, 39, 43, 47, 51, 55, 59, 55, 51, 47, 43, 39, 35, 31, 27, 23,
+    19, 15, 11,  7,  3, -1,  3,  7, 11, 15,  4,  8, 12, 16, 20, 24,
+    28, 32, 36, 40, 44, 48, 52, 56, 60, 56, 52, 48, 44, 40, 36, 32,
+    28, 24, 20, 16, 12,  8,  4,  0,  4,  8, 12, 16, 20, 24, 28, 32,
+    36, 40, 44, 48, 52, 56, 60, 56, 52, 48, 44, 40, 36, 32, 28, 24,
+    20, 16, 12,  8,  4,  0,  4,  8, 12, 16, 20, 24, 28, 32, 36, 40,
+    44, 48, 52, 56, 60, 56, 52, 48, 44, 40, 36, 32, 28, 24, 20, 16,
+    12,  8,  4,  0,  4,  8, 12, 16, 63, 59, 64, 60, 65, 61, 66, 62,
+    67, 63, 68, 64, -5,-10, -4, -9, -3, -8, -2, -7, -1, -6,  0, -5,
+     1,  6, 11, 16, 21, 26, 31, 36, 41, 46, 51, 56, 61, 56, 51, 46,
+    41, 36, 31, 26, 21, 16, 11,  6,  1, -4,  1,  6, 11, 16, 21, 26,
+    31, 36, 41, 46, 51, 56, 61, 56, 51, 46, 41, 36, 31, 26, 21, 16,
+    11,  6,  1, -4,  1,  6, 11, 16, 21, 26, 31, 36, 41, 46, 51, 56,
+    61, 56, 51, 46, 41, 36, 31, 26, 21, 16, 11,  6,  1, -4,  1,  6,
+    11, 16, 21, 26, 31, 36, 41, 46, 51, 56,  2,  7, 12, 17, 22, 27,
+    32, 37, 42, 47, 52, 57, 62, 57, 52, 47, 42, 37, 32, 27, 22, 17,
+    12,  7,  2, -3,  2,  7, 12, 17, 22, 27, 32, 37, 42, 47, 52, 57,
+    62, 57, 52, 47, 42, 37, 32, 27, 22, 17, 12,  7,  2, -3,  2,  7,
+    12, 17, 22, 27, 32, 37, 42, 47, 52, 57, 62, 57, 52, 47, 42, 37,
+    32, 27, 22, 17, 12,  7,  2, -3,  2,  7, 12, 17, 22, 27, 32, 37,
+    42, 47, 52, 57,  3,  8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58,
+    63, 58, 53, 48, 43, 38, 33, 28, 23, 18, 13,  8,  3, -2,  3,  8,
+    13, 18, 23, 28, 33, 38, 43, 48, 53, 58, 63, 58, 53, 48, 43, 38,
+    33, 28, 23, 18, 13,  8,  3, -2,  3,  8, 13, 18, 23, 28, 33, 38,
+    43, 48, 53, 58, 63, 58, 53, 48, 43, 38, 33, 28, 23, 18, 13,  8,
+     3, -2,  3,  8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58,  4,  9,
+    14, 19, 24, 29, 34, 39, 44, 49, 54, 59, 54, 49, 44, 39, 34, 29,
+    24, 19, 14,  9,  4, -1,  4,  9, 14, 19, 24, 29, 34, 39, 44, 49,
+    54, 59, 54, 49, 44, 39, 34, 29, 24, 19, 14,  9,  4, -1,  4,  9,
+    14, 19, 24, 29, 34, 39, 44, 49, 54, 59, 54, 49, 44, 39, 34, 29,
+    24, 19, 14,  9,  4, -1,  4,  9, 14, 19, 24, 29, 34, 39, 44, 49,
+    54, 59, 54, 49, 44, 39,  5, 10, 15, 20, 25, 30, 35, 40, 45, 50,
+    55, 60, 55, 50, 45, 40, 35, 30, 25, 20, 15, 10,  5,  0,  5, 10,
+    15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 55, 50, 45, 40, 35, 30,
+    25, 20, 15, 10,  5,  0,  5, 10, 15, 20, 25, 30, 35, 40, 45, 50,
+    55, 60, 55, 50, 45, 40, 35, 30, 25, 20, 15, 10,  5,  0,  5, 10,
+    15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 55, 50, 45, 40, 64, 59,
+    65, 60, 66, 61, 67, 62, 68, 63, 69, 64, -5,-11, -4,-10, -3, -9,
+    -2, -8, -1, -7,  0, -6,  1,  7, 13, 19, 25, 31, 37, 43, 49, 55,
+    61, 55, 49, 43, 37, 31, 25, 19, 13,  7,  1, -5,  1,  7, 13, 19,
+    25, 31, 37, 43, 49, 55, 61, 55, 49, 43, 37, 31, 25, 19, 13,  7,
+     1, -5,  1,  7, 13, 19, 25, 31, 37, 43, 49, 55, 61, 55, 49, 43,
+    37, 31, 25, 19, 13,  7,  1, -5,  1,  7, 13, 19, 25, 31, 37, 43,
+    49, 55, 61, 55, 49, 43, 37, 31, 25, 19, 13,  7,  2,  8, 14, 20,
+    26, 32, 38, 44, 50, 56, 62, 56, 50, 44, 38, 32, 26, 20, 14,  8,
+     2, -4,  2,  8, 14, 20, 26, 32, 38, 44, 50, 56, 62, 56, 50, 44,
+    38, 32, 26, 20, 14,  8,  2, -4,  2,  8, 14, 20, 26, 32, 38, 44,
+    50, 56, 62, 56, 50, 44, 38, 32, 26, 20, 14,  8,  2, -4,  2,  8,
+    14, 20, 26, 32, 38, 44, 50, 56, 62, 56, 50, 44, 38, 32, 26, 20,
+    14,  8,  3,  9, 15, 21, 27, 33, 39, 45, 51, 57, 63, 57, 51, 45,
+    39, 33, 27, 21, 15,  9,  3, -3,  3,  9, 15, 21, 27, 33, 39, 45,
+    51, 57, 63, 57, 51, 45, 39, 33, 27, 21, 15,  9,  3, -3,  3,  9,
+    15, 21, 27, 33, 39, 45, 51, 57, 63, 57, 51, 45, 39, 33, 27, 21,
+    15,  9,  3, -3,  3,  9, 15, 21, 27, 33, 39, 45, 51, 57, 63, 57,
+    51, 45, 39, 33, 27, 21, 15,  9,  4, 10, 16, 22, 28, 34, 40, 46,
+    52, 58, 64, 58, 52, 46, 40, 34, 28, 22, 16, 10,  4, -2,  4, 10,
+    16, 22, 28, 34, 40, 46, 52, 58, 64, 58, 52, 46, 40, 34, 28, 22,
+    16, 10,  4, -2,  4, 10, 16, 22, 28, 34, 40, 46, 52, 58, 64, 58,
+    52, 46, 40, 34, 28, 22, 16, 10,  4, -2,  4, 10, 16, 22, 28, 34,
+    40, 46, 52, 58, 64, 58, 52, 46, 40, 34, 28, 22, 16, 10,  5, 11,
+    17, 23, 29, 35, 41, 47, 53, 59, 53, 47, 41, 35, 29, 23, 17, 11,
+     5, -1,  5, 11, 17, 23, 29, 35, 41, 47, 53, 59, 53, 47, 41, 35,
+    29, 23, 17, 11,  5, -1,  5, 11, 17, 23, 29, 35, 41, 47, 53, 59,
+    53, 47, 41, 35, 29, 23, 17, 11,  5, -1,  5, 11, 17, 23, 29, 35,
+    41, 47, 53, 59, 53, 47, 41, 35, 29, 23, 17, 11,  5, -1,  5, 11,
+    17, 23,  6, 12, 18, 24, 30, 36, 42, 48, 54, 60, 54, 48, 42, 36,
+    30, 24, 18, 12,  6,  0,  6, 12, 18, 24, 30, 36, 42, 48, 54, 60,
+    54, 48, 42, 36, 30, 24, 18, 12,  6,  0,  6, 12, 18, 24, 30, 36,
+    42, 48, 54, 60, 54, 48, 42, 36, 30, 24, 18, 12,  6,  0,  6, 12,
+    18, 24, 30, 36, 42, 48, 54, 60, 54, 48, 42, 36, 30, 24, 18, 12,
+     6,  0,  6, 12, 18, 24, 65, 59, 66, 60, 67, 61, 68, 62, 69, 63,
+    70, 64,
+};
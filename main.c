@@ -2,6 +2,11 @@
 #include <stdlib.h>
 #include <time.h>
 #include <font_8x8.h>
+#include <intercept_table.h>
+#include <audio_link.h>
+#ifdef FAST_BOOT
+#include <title_image.h>
+#endif
 
 #define CS BIT3   // Chip Select line
 #define CD BIT1   // Command/Data mode line
@@ -9,6 +14,18 @@
 #define SCK BIT2  // Serial clock
 
 // TODO: ADD GAME CONSTANTS HERE
+/* Per-paddle AI state. Kept in the paddle so two AIs
+ * (player_select == ai_select) never share a decision
+ */
+struct ai_context
+{
+    int delay_counter; // frames waited since the ball changed direction
+    int target_y;      // y the paddle is moving towards
+    int intercept_y;   // predicted ball y at the paddle's column
+    int epoch;         // ball_epoch the prediction was made for
+    int pool_ball;     // pool ball the prediction was made for (multi-ball game)
+};
+
 struct ball
 {
     int x;
@@ -26,8 +43,11 @@ struct paddle
     int width;
     int y_vel;
     int score;
+    struct ai_context ai;
 };
 
+#define PADDLE_HIDDEN -64 // y of a paddle the panel doesn't show, see move_paddle
+
 const char ai_names[][8] = {
     {'M', 'r', '.', 'F', 'r', 'o', 'g', '\0'}, // Mr. Frog // Predictive
     "Dubnel",                                  // Dubnel // Top hitter
@@ -42,6 +62,583 @@ int speed_flag = 0;
 int game_point_flag = 0;
 int x_left = 0;
 int x_right = 0;
+unsigned int game_seed = 1; // state of game_rand(), never 0
+int ball_epoch = 0; // bumped every time the ball's velocity is changed by a hit or serve
+int headless_mode = 0; // no sound or 7-segment updates (AI tournament, link rollback)
+
+// Fast boot, build with FAST_BOOT defined: the intro is sent to the
+// audio MCU first, the setup runs during the panel's start up wait and
+// the title (title_image.h) goes out in one pass. The PROFILE build
+// shows the cycles from power-up to the title on the title screen.
+// Modeled in tools/game_emu.c (bus and delays only, not the code in
+// between): 217960 cycles without FAST_BOOT, 53952 with it.
+#define BOOT_SETTLE_TICKS (5500 / 8) // the panel's start up wait, Timer A1 at SMCLK / 8
+
+#define DISPLAY_DIGITS 4
+#define DISPLAY_TICK_HZ 1024  // TIMER0_A0_ISR rate, ACLK / 32
+#define DISPLAY_LEVELS 8      // brightness steps, lit for display_brightness ticks out of 8
+#define DISPLAY_BLINK_TICK 256 // blinking digits go dark every other 250ms
+#define DIGIT_BLANK 0x0F      // the BCD decoders light nothing above 9
+#define DIGIT_BLINK 0x80      // flag in display_digits
+
+// What the 7-segment display should show, by latch line (P8.1-P8.2),
+// digit 3 and 2 the player's score, 1 and 0 the computer's. Written by
+// the game, latched by TIMER0_A0_ISR.
+volatile unsigned char display_digits[DISPLAY_DIGITS];
+volatile unsigned char display_brightness = DISPLAY_LEVELS;
+unsigned char display_latched[DISPLAY_DIGITS]; // what the latches hold
+unsigned int display_tick = 0;
+volatile unsigned int clock_seconds = 0; // since power-up, counted by TIMER0_A0_ISR
+
+unsigned char audio_frame[AUDIO_FRAME_SIZE]; // the frame DMA1 is sending to the audio MCU
+
+#define GAME_POINT_TEMPO 24 // 16ths, songs hurry up from game point to game over
+
+// Uploaded to the audio MCU and played at game point
+const struct note game_point_notes[] = {
+    {NOTE_STEP(784), NOTE_MS(90)},
+    {NOTE_STEP(988), NOTE_MS(90)},
+    {NOTE_STEP(1175), NOTE_MS(180)},
+};
+
+#define TURBO_GAMES 3          // games per pairing in the AI tournament
+#define TURBO_MAX_STEPS 10000  // a game this long is called a draw
+int turbo_wins[4][4];          // [left AI][right AI] games won by the left AI
+int turbo_losses[4][4];        // and by the right AI, the rest were draws
+unsigned long turbo_cycles = 0;
+unsigned long turbo_steps = 0;
+
+#ifdef PROFILE
+// Frame profiler, build with PROFILE defined to get it. Phases are
+// timed with TA1R (see init_cycle_timer), so one phase must stay
+// below 65536 cycles: frames that pause or end the game wait for
+// the player and are not recorded (PROFILE_SKIP).
+#define PHASE_ADC 0
+#define PHASE_CLEAR 1
+#define PHASE_AI 2
+#define PHASE_PHYSICS 3
+#define PHASE_AUDIO 4 // play_music, also counted in the phase that called it
+#define PHASE_DRAW 5
+#define PHASE_FRAME 6
+#define PHASES 7
+#define PROFILE_BUCKETS 8 // histogram buckets: < 512, < 1024, ... , >= 32768 cycles
+
+const char phase_names[PHASES][8] = {"ADC", "CLEAR", "AI", "PHYSICS", "AUDIO", "DRAW", "FRAME"};
+
+struct phase_stats
+{
+    unsigned int min;
+    unsigned int max;
+    unsigned long total;
+    unsigned long calls;
+    unsigned int histogram[PROFILE_BUCKETS];
+};
+
+struct phase_stats profile[PHASES];
+unsigned int profile_start[PHASES];
+unsigned char profile_skipped = 0; // bit per phase, its PROFILE_END records nothing
+
+unsigned long boot_cycles; // power-up to the title on the panel
+
+#define PROFILE_BEGIN(phase) (profile_start[phase] = TA1R)
+#define PROFILE_END(phase) profile_end(phase)
+#define PROFILE_SKIP(phase) (profile_skipped |= 1 << (phase))
+#else
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#define PROFILE_SKIP(phase)
+#endif
+
+#ifdef TELEMETRY
+// Per-frame telemetry over the back-channel UART (USCI A1), build with
+// TELEMETRY defined. Decode with tools/telemetry_decode.c
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_RECORD_SIZE 16
+
+// Little endian, no padding, TELEMETRY_RECORD_SIZE bytes
+struct telemetry_record
+{
+    unsigned char sync;         // TELEMETRY_SYNC
+    unsigned char frame;        // low byte of the frame number, gaps are dropped records
+    signed char ball_x;
+    signed char ball_y;
+    signed char ball_x_vel;
+    signed char ball_y_vel;
+    signed char player_y;
+    signed char computer_y;
+    unsigned char scores;       // player score << 4 | computer score
+    signed char ai_move;        // how far the computer AI moved its paddle this frame
+    unsigned int frame_cycles;  // TA1R ticks for the whole frame
+    unsigned int spi_bytes;     // bytes sent to the LCD this frame
+    unsigned char ai_select;
+    unsigned char checksum;     // sum of the bytes from frame to ai_select
+};
+
+struct telemetry_record telemetry_record; // the record DMA0 is sending
+unsigned int telemetry_frame = 0;
+unsigned int telemetry_dropped = 0;
+unsigned int spi_bytes_sent = 0;  // counted by spi_IO and send_byte
+#endif
+
+#ifdef SPI_TRACE
+// LCD bus trace, build with SPI_TRACE defined. Every byte sent to the
+// panel is decoded the way the UC1701 sees it and checked against a
+// copy of the panel RAM, to count bytes that did not need sending.
+// The report goes out on the back-channel UART when the game is paused.
+// The game is seeded the same on every run, so the panel images can be
+// compared with golden ones (see tools/pbm_compare.c).
+#define SITE_OTHER 0
+#define SITE_INIT 1
+#define SITE_FILL 2 // write_zeros, write_ones
+#define SITE_DRAW_RECT 3
+#define SITE_CLEAR_RECT 4
+#define SITE_DRAW_BALL 5
+#define SITE_CLEAR_BALL 6
+#define SITE_STRING 7
+#define SITE_PADDLE 8 // move_paddle
+#define SITES 9
+#define SPI_TRACE_SEED 0x1D2B // for rand(), game_rand() is seeded from it
+
+const char site_names[SITES][12] = {
+    "other", "init_lcd", "fill", "draw_rect", "clear_rect", "draw_ball", "clear_ball", "draw_string", "paddle",
+};
+
+struct spi_site_stats
+{
+    unsigned long transactions; // CS low to CS high
+    unsigned long commands;
+    unsigned long data;
+    unsigned long same_data;    // data the panel already held
+    unsigned long same_address; // page or column sets to where the panel already was
+    unsigned long outside;      // data past column 101 or page 7
+};
+
+struct spi_site_stats spi_sites[SITES];
+int spi_trace_site = SITE_OTHER;
+unsigned char panel[8][102];    // what the panel RAM holds
+unsigned char panel_known[8][13]; // bit per column: panel[page][column] was written
+int panel_page = 0;
+int panel_column = 0;
+int panel_operand = 0;          // the next command byte belongs to the last one
+unsigned int frame_bytes = 0;   // bytes sent in the current frame
+unsigned int frame_waste = 0;   // of which did not need sending
+unsigned int frame_bytes_max = 0;
+unsigned int frame_waste_max = 0;
+unsigned int last_frame_bytes = 0;
+unsigned int last_frame_waste = 0;
+
+#define SPI_SITE(site) (spi_trace_site = (site))
+#define PANEL_DUMP(label) panel_dump(label)
+#else
+#define SPI_SITE(site)
+#define PANEL_DUMP(label)
+#endif
+
+#ifdef FRAME_BENCH
+// Frame cost benchmark, see run_frame_bench
+#define COST_SPI_BYTES 0
+#define COST_GPIO_WRITES 1
+#define COST_BUS_CYCLES 2   // modeled, SPI_BYTE_CYCLES per byte and SPI_CS_CYCLES per transaction
+#define COST_HEAP_CALLS 3   // malloc and free
+#define COST_DELAY_CYCLES 4 // sum of the __delay_cycles arguments
+#define COST_CYCLES 5       // measured with Timer A1
+#define COSTS 6
+#define SPI_BYTE_CYCLES 56 // 8 bits of MOSI, shift, SCK low, delay, SCK high, delay
+#define SPI_CS_CYCLES 12
+#define FRAME_BENCH_SCENARIOS 5
+#define FRAME_BENCH_FRAMES 200   // frames per scenario (fewer if the game ends first)
+#define FRAME_BENCH_SEED 0x1D2B  // for both rand() and game_rand()
+#define FRAME_BENCH_AI 3         // Andrzej plays both sides
+#define FRAME_BENCH_TOLERANCE 10 // percent a metric may grow past its baseline
+
+const char *const cost_names[COSTS] = {
+    "spi_bytes", "gpio_writes", "bus_cycles", "heap_calls", "delay_cycles", "cycles"};
+const char *const scenario_names[FRAME_BENCH_SCENARIOS] = {
+    "rally", "fast_ball", "serve", "pause", "game_over"};
+
+// Per frame costs of a trusted run, copied from its JSON. The counts
+// come out the same on the board and in tools/game_emu.c, which took
+// them. cycles is only measured on the board, so it isn't checked.
+#define NO_BASELINE 0xFFFFFFFFUL
+const unsigned long frame_bench_baseline[FRAME_BENCH_SCENARIOS][COSTS] = {
+    {47, 1179, 2806, 0, 775, NO_BASELINE}, // rally
+    {51, 1279, 3043, 0, 841, NO_BASELINE}, // fast_ball
+    {48, 1195, 2843, 0, 786, NO_BASELINE}, // serve
+    {68, 1691, 4021, 3, 1113, NO_BASELINE}, // pause
+    {69, 1713, 4062, 0, 1129, NO_BASELINE}, // game_over
+};
+unsigned long frame_cost[COSTS]; // totals of the scenario being played
+unsigned int frame_bench_frames = 0;
+int frame_bench_shown[2]; // paddle y's on the panel, see show_paddle
+
+#define FRAME_COST(cost, n) (frame_cost[cost] += (n))
+#else
+#define FRAME_COST(cost, n)
+#endif
+
+// Render benchmark, see run_render_benchmark
+#define MCLK_HZ 1000000UL // default DCO, the code never changes it
+#define BENCH_RUNS 8
+#define BENCH_TESTS 22
+
+struct bench_result
+{
+    char name[8];
+    unsigned long cycles; // per call
+    unsigned int bytes;   // SPI bytes per call
+};
+
+// Times BENCH_RUNS calls of 'call' into ticks
+#define BENCH(call)                               \
+    ticks = 0;                                    \
+    for (run = 0; run < BENCH_RUNS; run++)        \
+    {                                             \
+        start = TA1R;                             \
+        call;                                     \
+        ticks += (unsigned int)(TA1R - start);    \
+    }
+
+// Multi-ball pool, one array per field so each pass only touches what it needs
+#define MAX_BALLS 4
+int pool_x[MAX_BALLS];
+int pool_y[MAX_BALLS];
+int pool_x_vel[MAX_BALLS];
+int pool_y_vel[MAX_BALLS];
+int pool_count = 0;             // balls in play
+unsigned int pool_near = 0;     // bit i set if ball i is in a paddle column
+unsigned long pool_frame_ticks[MAX_BALLS]; // frame time per ball count, in 8 cycle ticks
+unsigned long pool_frames[MAX_BALLS];
+
+// Two console link over UART, see run_link_game
+#define LINK_HELLO 0x7E  // sent by the console that starts a linked game
+#define LINK_ACK 0x7F    // answer from the other console
+#define LINK_SEED 0x2A5B // both consoles serve from the same seed
+#define LINK_STATES 8    // saved frames, how far back a rollback can go
+#define LINK_INPUTS 16   // inputs kept per side (saved frames plus frames ahead)
+#define LINK_RX_SIZE 16
+
+// The link and the back-channel reports share USCI A1, see init_link
+#if defined(TELEMETRY) || defined(SPI_TRACE) || defined(FRAME_BENCH)
+#define LINK_ENABLED 0
+#else
+#define LINK_ENABLED 1
+#endif
+#define SHOW_STATS -2    // from wait_for_player_or_link: the stats page was asked for
+
+struct link_state
+{
+    struct paddle player;
+    struct paddle computer;
+    struct ball ball;
+    int count;
+    int speed_flag;
+    unsigned int seed;
+};
+
+struct link_state link_states[LINK_STATES];
+unsigned char link_local[LINK_INPUTS];  // our paddle y per frame
+unsigned char link_remote[LINK_INPUTS]; // other console's paddle y, or a guess
+int link_remote_frame = -1;             // last frame the other console's input arrived for
+int link_rx_frame = -1;                 // frame number of the input being received
+volatile unsigned char link_rx[LINK_RX_SIZE];
+volatile unsigned int link_rx_head = 0;
+unsigned int link_rx_tail = 0;
+
+// Game state snapshot in info flash, see save_snapshot
+#define SNAPSHOT_MAGIC 0x504E // "PN"
+#define SNAPSHOT_VERSION 1    // bump when struct snapshot changes
+
+struct snapshot
+{
+    unsigned int magic;    // all ones: slot not written yet
+    unsigned int sequence; // the highest is the newest
+    unsigned char version; // 0: used up, see clear_snapshot
+    unsigned char checksum;
+    signed char player_select;
+    unsigned char ai_select;
+    unsigned char paused;
+    signed char player_y;
+    signed char computer_y;
+    unsigned char player_score;
+    unsigned char computer_score;
+    signed char ball_x;
+    signed char ball_y;
+    signed char ball_x_vel;
+    signed char ball_y_vel;
+    unsigned char speed_flag;
+    unsigned char game_point_flag;
+    unsigned char ai_current; // bit 0 player, bit 1 computer: prediction still valid
+    int count;
+    unsigned int seed;
+    signed char ai_delay[2];
+    signed char ai_target_y[2];
+    signed char ai_intercept_y[2];
+};
+
+#ifndef INFO_FLASH
+#define INFO_FLASH ((unsigned char *)0x1800) // info memory, segments D, C, B and A of 128 bytes
+#endif
+
+// Info memory segments D and C, each filled with snapshots in order
+unsigned char *const snapshot_segments[2] = {
+    INFO_FLASH,
+    INFO_FLASH + 0x80,
+};
+#define SNAPSHOT_SLOTS (128 / sizeof(struct snapshot))
+
+// Match statistics log in info flash, see record_match
+#define STATS_MAGIC 0x5453 // "ST", change when struct stats or struct stats_game do
+#define STATS_GAMES ((128 - sizeof(struct stats)) / sizeof(struct stats_game))
+
+// Totals, at the start of a stats segment and kept in RAM
+struct stats
+{
+    unsigned int magic;
+    unsigned int sequence; // the higher of the two segments is the newest
+    unsigned int played[4]; // per ai_names entry, on either side
+    unsigned int won[4];
+    unsigned long play_seconds;
+    unsigned int longest_rally; // paddle hits in one point
+    unsigned char max_speed;    // fastest ball, |x_vel|
+    unsigned char checksum;
+};
+
+// One game, appended after the totals until the segment is full
+struct stats_game
+{
+    unsigned char sides; // computer's AI, player's AI + 1 (0 for a person) in the high nibble
+    unsigned char computer_won;
+    unsigned int longest_rally;
+    unsigned int seconds;
+    unsigned char max_speed;
+    unsigned char checksum;
+};
+
+// Info memory segments B and A
+unsigned char *const stats_segments[2] = {
+    INFO_FLASH + 0x100,
+    INFO_FLASH + 0x180,
+};
+
+struct stats stats;           // totals of every game in the log
+unsigned char *stats_segment; // holding the newest totals, 0 if none
+unsigned int stats_games;     // game slots used in stats_segment
+
+// The game under way, put in the log at game over
+unsigned int match_rally;
+unsigned int match_longest_rally;
+unsigned char match_max_speed;
+unsigned int match_start; // clock_seconds
+
+/* Pseudo random numbers for the game rules (serves). A 16 bit
+ * xorshift keeps the sequence in game_seed, so two linked
+ * consoles given the same seed serve the same way.
+ * The AIs keep using rand().
+ */
+int game_rand()
+{
+    game_seed = (game_seed ^ (game_seed << 7)) & 0xFFFF; // 16 bits on the host too
+    game_seed ^= game_seed >> 9;
+    game_seed = (game_seed ^ (game_seed << 8)) & 0xFFFF;
+    return game_seed & 0x7FFF;
+}
+
+#ifdef PROFILE
+/* Adds one timing of a phase to its statistics
+ */
+void profile_record(int phase, unsigned int cycles)
+{
+    struct phase_stats *stats = &profile[phase];
+    unsigned int bucket = 0;
+    unsigned int limit = 512;
+
+    if (stats->calls == 0 || cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+    stats->total += cycles;
+    stats->calls++;
+
+    while (bucket < PROFILE_BUCKETS - 1 && cycles >= limit)
+    {
+        bucket++;
+        limit <<= 1;
+    }
+    stats->histogram[bucket]++;
+}
+
+/* Records the time since PROFILE_BEGIN(phase), unless the phase
+ * was marked with PROFILE_SKIP since
+ */
+void profile_end(int phase)
+{
+    if (profile_skipped & (1 << phase))
+    {
+        profile_skipped &= ~(1 << phase);
+        return;
+    }
+    profile_record(phase, TA1R - profile_start[phase]);
+}
+
+/* Returns the phase (not counting the whole frame)
+ * with the slowest time seen so far
+ */
+int profile_worst_phase()
+{
+    int phase, worst = 0;
+    for (phase = 1; phase < PHASE_FRAME; phase++)
+    {
+        if (profile[phase].max > profile[worst].max)
+        {
+            worst = phase;
+        }
+    }
+    return worst;
+}
+#endif
+
+#if defined(SPI_TRACE) || defined(FRAME_BENCH)
+/* Sends a byte on the back-channel UART (USCI A1, see init_link)
+ */
+void trace_send(unsigned char byte)
+{
+    while (!(UCA1IFG & UCTXIFG))
+        ;
+    UCA1TXBUF = byte;
+}
+#endif
+
+#ifdef SPI_TRACE
+/* Decodes one byte on its way to the panel, using the CD line to
+ * tell commands from data
+ */
+void spi_trace_byte(unsigned char byte)
+{
+    struct spi_site_stats *site = &spi_sites[spi_trace_site];
+    int column;
+
+    frame_bytes++;
+    if (!(P3OUT & CD))
+    {
+        site->commands++;
+        if (panel_operand)
+        {
+            panel_operand = 0;
+        }
+        else if (byte == 0x81 || byte == 0xF8 || byte == 0xFA) // contrast, booster, advanced control
+        {
+            panel_operand = 1;
+        }
+        else if ((byte & 0xF0) == 0xB0)
+        {
+            if ((byte & 0x0F) == panel_page)
+            {
+                site->same_address++;
+                frame_waste++;
+            }
+            panel_page = byte & 0x0F;
+        }
+        else if ((byte & 0xF0) == 0x00 || (byte & 0xF0) == 0x10)
+        {
+            column = (byte & 0x10) ? (panel_column & 0x0F) | ((byte & 0x0F) << 4)
+                                   : (panel_column & 0xF0) | (byte & 0x0F);
+            if (column == panel_column)
+            {
+                site->same_address++;
+                frame_waste++;
+            }
+            panel_column = column;
+        }
+        return;
+    }
+
+    site->data++;
+    if (panel_page >= 8 || panel_column >= 102)
+    {
+        site->outside++;
+        frame_waste++;
+    }
+    else
+    {
+        unsigned char *known = &panel_known[panel_page][panel_column >> 3];
+        unsigned char bit = 1 << (panel_column & 7);
+        if ((*known & bit) && panel[panel_page][panel_column] == byte)
+        {
+            site->same_data++;
+            frame_waste++;
+        }
+        panel[panel_page][panel_column] = byte;
+        *known |= bit;
+    }
+    panel_column++; // the panel moves to the next column after data
+}
+
+/* Sends the copy of the panel RAM as a binary PBM image (P4),
+ * 102x64, with the label as its comment line. Pixels never
+ * written are sent as off. tools/pbm_compare.c picks the
+ * images out of the UART stream and checks them.
+ */
+void panel_dump(const char *label)
+{
+    const char *header = "P4\n# ";
+    unsigned char bits;
+    int x, y;
+
+    while (*header != '\0')
+    {
+        trace_send(*header++);
+    }
+    while (*label != '\0')
+    {
+        trace_send(*label++);
+    }
+    header = "\n102 64\n";
+    while (*header != '\0')
+    {
+        trace_send(*header++);
+    }
+
+    for (y = 0; y < 64; y++)
+    {
+        bits = 0;
+        for (x = 0; x < 104; x++)
+        {
+            bits <<= 1;
+            if (x < 102 && (panel_known[y >> 3][x >> 3] & (1 << (x & 7))) && (panel[y >> 3][x] & (1 << (y & 7))))
+            {
+                bits |= 1;
+            }
+            if ((x & 7) == 7)
+            {
+                trace_send(bits);
+                bits = 0;
+            }
+        }
+    }
+}
+
+/* Closes the trace of one frame
+ */
+void spi_trace_frame()
+{
+    last_frame_bytes = frame_bytes;
+    last_frame_waste = frame_waste;
+    if (frame_bytes > frame_bytes_max)
+    {
+        frame_bytes_max = frame_bytes;
+    }
+    if (frame_waste > frame_waste_max)
+    {
+        frame_waste_max = frame_waste;
+    }
+    frame_bytes = 0;
+    frame_waste = 0;
+}
+#endif
 
 /* Write data to slave device.  Since the LCD panel is
  * write-only, we don't worry about reading any bits.
@@ -51,12 +648,25 @@ void spi_IO(unsigned char data[], int bytes)
 {
     int i, n;
 
+#ifdef TELEMETRY
+    spi_bytes_sent += bytes;
+#endif
+    FRAME_COST(COST_SPI_BYTES, bytes);
+    FRAME_COST(COST_GPIO_WRITES, 3 + 24 * bytes); // CD and CS, then MOSI and SCK twice per bit
+    FRAME_COST(COST_BUS_CYCLES, SPI_CS_CYCLES + SPI_BYTE_CYCLES * (unsigned long)bytes);
+    FRAME_COST(COST_DELAY_CYCLES, 1 + 16 * (unsigned long)bytes);
     // Set Chip Select low, so LCD panel knows we are talking to it.
     P3OUT &= ~CS;
     __delay_cycles(1);
+#ifdef SPI_TRACE
+    spi_sites[spi_trace_site].transactions++;
+#endif
 
     for (n = 0; n < bytes; n++)
     {
+#ifdef SPI_TRACE
+        spi_trace_byte(data[n]);
+#endif
         for (i = 0; i < 8; i++)
         {
             // Put bits on the line, most significant bit first.
@@ -90,6 +700,7 @@ void spi_IO(unsigned char data[], int bytes)
  * sequence to initialize the panel. */
 void init_lcd(void)
 {
+    SPI_SITE(SITE_INIT);
     unsigned char data[] = {
         0x40, // display start line 0
         0xA1, // SEG reverse
@@ -118,6 +729,7 @@ void init_lcd(void)
  * the 8*8 = 64 pixel height of the display. */
 void write_zeros(void)
 {
+    SPI_SITE(SITE_FILL);
     unsigned char zeros[17];
     int i, j, page;
 
@@ -147,6 +759,7 @@ void write_zeros(void)
  * the 8*8 = 64 pixel height of the display. */
 void write_ones(void)
 {
+    SPI_SITE(SITE_FILL);
     unsigned char ones[17];
     int i, j, page;
 
@@ -169,10 +782,40 @@ void write_ones(void)
     }
 }
 
+#ifdef FAST_BOOT
+/* Sends a whole screen from flash, page by page, in 17 byte
+ * bursts like write_zeros */
+void draw_image(const unsigned char image[8][102])
+{
+    SPI_SITE(SITE_FILL);
+    unsigned char data[17];
+    int i, j, page;
+
+    for (page = 0; page < 8; page++)
+    {
+        P3OUT &= ~CD;          // set for commands
+        data[0] = 0xB0 + page; // set page
+        data[1] = 0x00;        // LSB of column address is 0
+        data[2] = 0x10;        // MSB of column address is 0
+        spi_IO(data, 3);
+
+        P3OUT |= CD; // set for data
+        for (i = 0; i < 6; i++)
+        {
+            for (j = 0; j < 17; j++)
+                data[j] = image[page][i * 17 + j];
+
+            spi_IO(data, sizeof(data));
+        }
+    }
+}
+#endif
+
 /* Draws a ball on the screen.  The ball is defined by
  * the upper left corner (x, y) */
 void draw_ball(int x, int y)
 {
+    SPI_SITE(SITE_DRAW_BALL);
     int ball_size = 4;
     int page_start, page_end, i, page;
     unsigned char data[4] = {0};
@@ -212,6 +855,7 @@ void draw_ball(int x, int y)
  * the upper left corner (x, y) */
 void clear_ball(int x, int y)
 {
+    SPI_SITE(SITE_CLEAR_BALL);
     int ball_size = 4;
     int page_start, page_end, i, page;
     unsigned char data[4];
@@ -243,6 +887,7 @@ void clear_ball(int x, int y)
  * the upper left corner (x, y) and the width and height */
 void draw_rectangle(int x, int y, int width, int height)
 {
+    SPI_SITE(SITE_DRAW_RECT);
     int page_start, page_end, i, page;
 
     // Calculate the start and end pages for the rectangle
@@ -267,7 +912,7 @@ void draw_rectangle(int x, int y, int width, int height)
             // Calculate the byte to draw based on the current page and y coordinate
             if (page == page_start)
             {
-                data[i] |= 0xFF << (y % 8);
+                data[i] = 0xFF << (y % 8);
             }
             else if (page == page_end)
             {
@@ -283,6 +928,7 @@ void draw_rectangle(int x, int y, int width, int height)
 
         // Free the memory allocated for the data array
         free(data);
+        FRAME_COST(COST_HEAP_CALLS, 2);
     }
 }
 
@@ -290,6 +936,7 @@ void draw_rectangle(int x, int y, int width, int height)
  * the upper left corner (x, y) and the width and height */
 void clear_rectangle(int x, int y, int width, int height)
 {
+    SPI_SITE(SITE_CLEAR_RECT);
     int page_start, page_end, i, page;
 
     // Calculate the start and end pages for the rectangle
@@ -319,7 +966,149 @@ void clear_rectangle(int x, int y, int width, int height)
 
         // Free the memory allocated for the data array
         free(data);
+        FRAME_COST(COST_HEAP_CALLS, 2);
+    }
+}
+
+/* The byte of page a block of height rows from row y shows in every
+ * one of its columns
+ */
+unsigned char paddle_bits(int y, int height, int page)
+{
+    int top = y - 8 * page;
+    int bottom = top + height;
+
+    if (top < 0)
+    {
+        top = 0;
+    }
+    if (bottom > 8)
+    {
+        bottom = 8;
+    }
+    if (top >= bottom)
+    {
+        return 0;
+    }
+    return (unsigned char)(0xFF << top) & (0xFF >> (8 - bottom));
+}
+
+/* Moves a paddle (a width x height block at column x, width up to
+ * 16) the panel shows at old_y to new_y. Without a copy of the panel
+ * RAM, the bytes of every page are worked out from the two y's and
+ * only the pages whose byte changes are sent, in one pass: a one
+ * pixel move sends one or two pages. old_y is PADDLE_HIDDEN if the
+ * panel doesn't show the paddle.
+ */
+void move_paddle(int x, int old_y, int new_y, int width, int height)
+{
+    SPI_SITE(SITE_PADDLE);
+    unsigned char data[16];
+    int top = new_y, bottom = new_y + height;
+    int page, i;
+
+    if (old_y != PADDLE_HIDDEN)
+    {
+        if (old_y < top)
+        {
+            top = old_y;
+        }
+        if (old_y + height > bottom)
+        {
+            bottom = old_y + height;
+        }
+    }
+
+    for (page = top / 8; page <= (bottom - 1) / 8; page++)
+    {
+        unsigned char bits = paddle_bits(new_y, height, page);
+        if (bits == (old_y == PADDLE_HIDDEN ? 0 : paddle_bits(old_y, height, page)))
+        {
+            continue;
+        }
+
+        P3OUT &= ~CD;                       // set for commands
+        data[0] = 0xB0 + page;              // set page
+        data[1] = 0x00 + (x & 0x0F);        // LSB of column address
+        data[2] = 0x10 + ((x >> 4) & 0x0F); // MSB of column address
+        spi_IO(data, 3);
+
+        P3OUT |= CD; // set for data
+        for (i = 0; i < width; i++)
+        {
+            data[i] = bits;
+        }
+        spi_IO(data, width);
+    }
+}
+
+/* Draws paddle where it is now, *shown_y being where the panel
+ * shows it (PADDLE_HIDDEN if it doesn't)
+ */
+void show_paddle(struct paddle *paddle, int *shown_y)
+{
+    move_paddle(paddle->x, *shown_y, paddle->y, paddle->width, paddle->height);
+    *shown_y = paddle->y;
+}
+
+/* Clears paddle from the panel, so the next show_paddle draws it whole
+ */
+void hide_paddle(struct paddle *paddle, int *shown_y)
+{
+    if (*shown_y != PADDLE_HIDDEN)
+    {
+        clear_rectangle(paddle->x, *shown_y, paddle->width, paddle->height);
+        *shown_y = PADDLE_HIDDEN;
+    }
+}
+
+/* draw_ball and clear_ball write whole bytes, so a ball at x behind
+ * the paddle (sharing its columns) wipes the paddle's rows in those
+ * pages. Hides such a paddle, show_paddle then draws it whole.
+ */
+void hide_paddle_under_ball(int x, struct paddle *paddle, int *shown_y)
+{
+    if (x < paddle->x + paddle->width && x + 4 > paddle->x)
+    {
+        hide_paddle(paddle, shown_y);
+    }
+}
+
+/* Sends one command frame to the audio MCU (see audio_link.h).
+ * DMA1 moves the bytes to USCI B1, so this returns after building
+ * the frame. It only waits if the previous frame is still going
+ * out (128 cycles a byte): DMA1 done and its last byte out of
+ * UCB1TXBUF.
+ */
+void audio_send(int command, const unsigned char *payload, int length)
+{
+    unsigned char sum = command + length;
+    int i;
+
+    if (headless_mode)
+    {
+        return;
     }
+    while ((DMA1CTL & DMAEN) || !(UCB1IFG & UCTXIFG))
+        ;
+    audio_frame[0] = AUDIO_SYNC;
+    audio_frame[1] = command;
+    audio_frame[2] = length;
+    for (i = 0; i < length; i++)
+    {
+        audio_frame[3 + i] = payload[i];
+        sum += payload[i];
+    }
+    audio_frame[3 + length] = sum;
+
+    // The first byte goes out by hand, every TX interrupt flag
+    // after it triggers the DMA for the next one
+    DMACTL0 = (DMACTL0 & 0x00FF) | DMA1TSEL_23; // UCB1TXIFG
+    __data16_write_addr((unsigned short)&DMA1SA, (unsigned long)&audio_frame[1]);
+    __data16_write_addr((unsigned short)&DMA1DA, (unsigned long)&UCB1TXBUF);
+    DMA1SZ = length + 3;
+    DMA1CTL = DMADT_0 + DMASRCINCR_3 + DMADSTINCR_0 + DMASBDB + DMAEN;
+    UCB1TXBUF = audio_frame[0];
 }
 
 /* Sends music select signal to other MSP430
@@ -331,12 +1120,61 @@ void clear_rectangle(int x, int y, int width, int height)
  */
 void play_music(int sel)
 {
-    P1OUT &= ~(BIT2 + BIT3);
-    sel = sel << 2;
-    P1OUT |= sel;
-    P1OUT |= BIT4;
-    __delay_cycles(5000); // DELAY FOR 5000 microseconds = 5 milliseconds
-    P1OUT &= ~BIT4;
+    unsigned char song = sel;
+
+    PROFILE_BEGIN(PHASE_AUDIO);
+    audio_send(AUDIO_PLAY_SONG, &song, 1);
+    PROFILE_END(PHASE_AUDIO);
+}
+
+/* Plays sound sel with every note's pitch scaled by pitch / 16
+ */
+void play_effect(int sel, int pitch)
+{
+    unsigned char payload[2];
+
+    payload[0] = sel;
+    payload[1] = pitch;
+    PROFILE_BEGIN(PHASE_AUDIO);
+    audio_send(AUDIO_PLAY_EFFECT, payload, 2);
+    PROFILE_END(PHASE_AUDIO);
+}
+
+/* Silences the audio MCU and drops the sounds waiting there
+ */
+void stop_music()
+{
+    audio_send(AUDIO_STOP, 0, 0);
+}
+
+/* Plays every song at tempo / 16 of its written speed
+ */
+void set_music_tempo(int tempo)
+{
+    unsigned char payload = tempo;
+    audio_send(AUDIO_SET_TEMPO, &payload, 1);
+}
+
+/* Replaces the audio MCU's uploaded song (SONG_UPLOADED) with
+ * count (up to AUDIO_UPLOAD_NOTES) notes or rests, see audio_link.h
+ */
+void upload_music(const struct note *notes, int count)
+{
+    unsigned char payload[AUDIO_MAX_PAYLOAD];
+    int i;
+
+    if (count > AUDIO_UPLOAD_NOTES)
+    {
+        count = AUDIO_UPLOAD_NOTES;
+    }
+    for (i = 0; i < count; i++)
+    {
+        payload[4 * i] = notes[i].step & 0xFF;
+        payload[4 * i + 1] = notes[i].step >> 8;
+        payload[4 * i + 2] = notes[i].ticks & 0xFF;
+        payload[4 * i + 3] = notes[i].ticks >> 8;
+    }
+    audio_send(AUDIO_UPLOAD, payload, 4 * count);
 }
 
 /* Moves the ball based on its velocity defined
@@ -401,6 +1239,26 @@ void init_SPI()
     P3OUT |= CS + SCK;
 }
 
+/* Initializes USCI B1 as the SPI master of the audio link
+ * (see audio_link.h), mapped to the free pins
+ * SIMO = P4.6
+ * CLK = P4.7
+ */
+void init_audio_link()
+{
+    PMAPKEYID = PMAPKEY; // unlock the port mapping
+    P4MAP6 = PM_UCB1SIMO;
+    P4MAP7 = PM_UCB1CLK;
+    PMAPKEYID = 0;
+    P4SEL |= BIT6 + BIT7;
+    UCB1CTL1 |= UCSWRST;
+    UCB1CTL0 = UCMST + UCSYNC + UCMSB + UCCKPH; // 3-pin SPI master, same phase as the audio MCU
+    UCB1CTL1 |= UCSSEL_2;                        // SMCLK
+    UCB1BR0 = AUDIO_LINK_DIVIDER;
+    UCB1BR1 = 0;
+    UCB1CTL1 &= ~UCSWRST;
+}
+
 /* Initializes ADC on pin 6.0
  */
 void init_ADC()
@@ -414,10 +1272,20 @@ void init_ADC()
                                       // one is selected on reset so this line is not needed
 }
 
+/* Starts Timer A1 free running on SMCLK, so TA1R counts
+ * CPU cycles (1MHz). Differences of TA1R time anything
+ * shorter than 65536 cycles.
+ */
+void init_cycle_timer()
+{
+    TA1CTL = TASSEL_2 + MC_2 + TACLR; // SMCLK, continuous mode
+}
+
 /* Initialize PINS for the 7-Segment Display and set to 0
  * P4.0(LSD) - P4.3(MSD) = Data
  * P8.1(LSD) - P8.2(MSD) = Latch
  * P7.0 = Strobe
+ * Timer A0 runs TIMER0_A0_ISR, which latches display_digits
  */
 void init_MPD()
 {
@@ -425,18 +1293,14 @@ void init_MPD()
     P8DIR |= (BIT1 + BIT2);
     P7DIR |= BIT0;
     int i;
-    for (i = 0; i < 4; i++)
+    for (i = 0; i < DISPLAY_DIGITS; i++)
     {
-        // GET NUMBER TO SET FROM ARR
-        P4OUT = 0;
-
-        // STROBE
-        P7OUT = 0b00000000;
-        P7OUT = 0b00000001;
-
-        // SELECT NEXT DISPLAY FOR NEXT LOOP
-        P8OUT -= (1 << 1);
+        display_digits[i] = 0;
+        display_latched[i] = 0xFF; // latch every digit on the first tick
     }
+    TA0CCR0 = 32768 / DISPLAY_TICK_HZ - 1;
+    TA0CCTL0 = CCIE;
+    TA0CTL = TASSEL_1 + MC_1 + TACLR; // ACLK (REFO), up mode
 }
 
 /* Plays game start music and draw through every page and clears them
@@ -608,9 +1472,83 @@ void move_ai_edge_hitter(struct paddle *computer, struct ball *ball)
     }
 }
 
-/* Moves the computer paddle towards the estimated location
+/* Looks up the ball's y after 'frames' calls to move_ball()
+ * in the flash tables of intercept_table.h (see tools/gen_intercept.c).
+ * States outside the table return y, ie. the AI just chases the ball.
+ */
+int intercept_lookup(int y, int y_vel, int frames)
+{
+    int mirror = 0;
+    unsigned int start;
+
+    if (y_vel == 0)
+    {
+        return y;
+    }
+    if (y_vel < 0)
+    {
+        // Downward paths are stored as the mirror image of upward ones
+        y = INTERCEPT_SPAN - y;
+        y_vel = -y_vel;
+        mirror = 1;
+    }
+    if (y_vel > INTERCEPT_MAX_Y_SPEED || y < INTERCEPT_Y_MIN || y > INTERCEPT_Y_MAX)
+    {
+        return mirror ? INTERCEPT_SPAN - y : y;
+    }
+
+    start = intercept_start[y_vel - 1][y - INTERCEPT_Y_MIN];
+    if (start & INTERCEPT_TWO_CYCLE)
+    {
+        y = intercept_path[(start & ~INTERCEPT_TWO_CYCLE) + (frames & 1)];
+    }
+    else
+    {
+        y = intercept_path[start + frames];
+    }
+    return mirror ? INTERCEPT_SPAN - y : y;
+}
+
+/* Predicts the y coordinate of the ball when it reaches the
+ * column of the paddle, bounces off the walls included.
+ * Uses table lookups only, no divides.
+ */
+int predict_intercept(struct paddle *paddle, struct ball *ball)
+{
+    int dist, speed;
+
+    // Distance to the first x that counts as a hit in collides()
+    if (paddle->x > 50)
+    {
+        dist = paddle->x - ball->size + 1 - ball->x;
+        speed = ball->x_vel;
+    }
+    else
+    {
+        dist = ball->x - (paddle->x + paddle->width - 1);
+        speed = -ball->x_vel;
+    }
+    if (dist <= 0 || speed <= 0)
+    {
+        return ball->y;
+    }
+    if (dist > INTERCEPT_MAX_DIST)
+    {
+        dist = INTERCEPT_MAX_DIST;
+    }
+    if (speed > INTERCEPT_MAX_X_SPEED)
+    {
+        speed = INTERCEPT_MAX_X_SPEED;
+    }
+
+    return intercept_lookup(ball->y, ball->y_vel, intercept_frames[speed - 1][dist]);
+}
+
+/* Moves the computer paddle towards the predicted location
  * of the ball, with some variability and occasional
  * mistakes to simulate human-like behavior.
+ * The prediction is only redone when the ball changes
+ * direction (see ball_epoch), not every frame.
  */
 void move_ai_predictive(struct paddle *computer, struct ball *ball)
 {
@@ -618,9 +1556,8 @@ void move_ai_predictive(struct paddle *computer, struct ball *ball)
     int mistake_margin = 5;     // How much the AI paddle will miss by
     int reaction_delay = 3;     // Delay in reacting to the ball's movement
     int is_ball_coming = 0;
+    struct ai_context *ai = &computer->ai;
 
-    static int delay_counter = 0;
-    static int target_y = -1;
     if (computer->x > 50)
     {
         is_ball_coming = ball->x_vel > 0;
@@ -631,43 +1568,54 @@ void move_ai_predictive(struct paddle *computer, struct ball *ball)
     }
     if (is_ball_coming)
     {
-        // React to the ball's movement after a certain delay
-        if (delay_counter < reaction_delay)
+        // A new path for the ball restarts the reaction delay
+        if (ai->epoch != ball_epoch)
         {
-            delay_counter++;
-            return;
+            ai->epoch = ball_epoch;
+            ai->delay_counter = 0;
         }
 
-        delay_counter = 0;
-
-        // Occasionally make a mistake
-        if (rand() % 100 < chance_of_mistake)
+        // React to the ball's movement after a certain delay
+        if (ai->delay_counter < reaction_delay)
         {
-            target_y = ball->y + ((rand() % 2) ? mistake_margin : -mistake_margin);
+            ai->delay_counter++;
+            return;
         }
-        else
+
+        // Decide once per path, the intercept won't change until the ball does
+        if (ai->delay_counter == reaction_delay)
         {
-            // Move the paddle towards the ball's y-coordinate
-            // add a non-zero random number to make the AI more human-like
-            int rand_num = rand() % 7 - 3;
-            target_y = ball->y - computer->height / 2 + rand_num;
-            // target_y = ball->y - computer->height / 2 + rand() % 7 - 3;// adds a random
+            ai->delay_counter++;
+            ai->intercept_y = predict_intercept(computer, ball);
+
+            // Occasionally make a mistake
+            if (rand() % 100 < chance_of_mistake)
+            {
+                ai->target_y = ai->intercept_y + ((rand() % 2) ? mistake_margin : -mistake_margin);
+            }
+            else
+            {
+                // Move the paddle towards the predicted y-coordinate
+                // add a non-zero random number to make the AI more human-like
+                int rand_num = rand() % 7 - 3;
+                ai->target_y = ai->intercept_y + 2 - computer->height / 2 + rand_num;
+            }
         }
     }
 
     // Keep the paddle within the screen boundaries
-    if (target_y < 0)
+    if (ai->target_y < 0)
     {
-        target_y = 0;
+        ai->target_y = 0;
     }
-    else if (target_y > 48)
+    else if (ai->target_y > 48)
     {
-        target_y = 48;
+        ai->target_y = 48;
     }
 
     // Move the paddle smoothly towards the target position
     int speed_limit = computer->height / 2;
-    int y_diff = target_y - computer->y;
+    int y_diff = ai->target_y - computer->y;
 
     if (y_diff > speed_limit)
     {
@@ -679,10 +1627,17 @@ void move_ai_predictive(struct paddle *computer, struct ball *ball)
     }
     else
     {
-        computer->y = target_y;
+        computer->y = ai->target_y;
     }
 }
 
+void (*const ai_functions[4])(struct paddle *, struct ball *) = {
+    move_ai_predictive,
+    move_ai_edge_hitter,
+    move_ai_raveel,
+    move_ai_middle_hitter,
+};
+
 /* Get reading from ADC and return a number between 0 and 63
  */
 char get_adc_position()
@@ -694,6 +1649,17 @@ char get_adc_position()
     return adc_position;
 }
 
+/* Clears the AI state of a paddle for a new game
+ */
+void reset_ai_context(struct paddle *paddle)
+{
+    paddle->ai.delay_counter = 0;
+    paddle->ai.target_y = paddle->y;
+    paddle->ai.intercept_y = paddle->y;
+    paddle->ai.epoch = -1;
+    paddle->ai.pool_ball = -1;
+}
+
 /* sets up the game by setting the initial values of the
  * player, computer, and ball
  */
@@ -701,7 +1667,7 @@ void set_up_game(struct paddle *player, struct paddle *computer, struct ball *ba
 {
     // TODO: Make all of these constants
     // Generate a random number between 0 and 1
-    int random_num = rand() % 2;
+    int random_num = game_rand() % 2;
     count = 0;
     speed_flag = 0;
     game_point_flag = 0;
@@ -724,6 +1690,15 @@ void set_up_game(struct paddle *player, struct paddle *computer, struct ball *ba
     ball->size = 4;
     ball->x_vel = 1;
     ball->y_vel = random_num;
+    ball_epoch++;
+
+    reset_ai_context(player);
+    reset_ai_context(computer);
+
+    match_rally = 0;
+    match_longest_rally = 0;
+    match_max_speed = 1;
+    match_start = clock_seconds;
 }
 
 /* Checks if the ball collides with either paddle
@@ -738,7 +1713,6 @@ void check_collision(struct ball *ball, struct paddle *player, struct paddle *co
 
     if (collides(ball, player, computer))
     {
-        play_music(1);
         if (ball->x_vel < 0)
         {
             ball->x = player->x + player->width + 1;
@@ -760,7 +1734,33 @@ void check_collision(struct ball *ball, struct paddle *player, struct paddle *co
             ball->y_vel += dir;
             speed_flag = 0;
         }
+        ball_epoch++;
+        if (++match_rally > match_longest_rally)
+        {
+            match_longest_rally = match_rally;
+        }
+        if (abs(ball->x_vel) > match_max_speed)
+        {
+            match_max_speed = abs(ball->x_vel);
+        }
+        // Faster balls hit higher: as written at speed 1, an octave up at 5
+        play_effect(1, 12 + 4 * abs(ball->x_vel));
+    }
+}
+
+/* Puts a score in two digits of the 7-segment display, blinking on
+ * game point. tens and ones are the latch lines (P8OUT) of the two
+ * digits; TIMER0_A0_ISR shows them
+ */
+void display_score(int score, int tens, int ones)
+{
+    if (headless_mode)
+    {
+        return;
     }
+    unsigned char blink = score == 4 ? DIGIT_BLINK : 0;
+    display_digits[tens >> 1] = score / 10 | blink;
+    display_digits[ones >> 1] = score % 10 | blink;
 }
 
 /*  Check if ball is out of bounds
@@ -770,9 +1770,9 @@ void update_score(struct paddle *player, struct paddle *computer, struct ball *b
 {
 
     // Generate a random number between 0 and 1
-    int random_num_x = rand() % 2;
+    int random_num_x = game_rand() % 2;
     random_num_x = (random_num_x == 0) ? 1 : -1;
-    int random_num_y = rand() % 2;
+    int random_num_y = game_rand() % 2;
     random_num_y = (random_num_y == 0) ? 1 : -1;
 
     if (ball->x <= -4)
@@ -784,15 +1784,9 @@ void update_score(struct paddle *player, struct paddle *computer, struct ball *b
         ball->size = 4;
         ball->x_vel = random_num_x;
         ball->y_vel = random_num_y;
-
-        P4OUT = computer->score / 10;
-        P8OUT = 2;
-        P7OUT = 0b00000000;
-        P7OUT = 0b00000001;
-        P4OUT = computer->score % 10;
-        P8OUT = 0;
-        P7OUT = 0b00000000;
-        P7OUT = 0b00000001;
+        ball_epoch++;
+        match_rally = 0;
+        display_score(computer->score, 2, 0);
     }
     else if (ball->x >= 97)
     {
@@ -803,15 +1797,103 @@ void update_score(struct paddle *player, struct paddle *computer, struct ball *b
         ball->size = 4;
         ball->x_vel = random_num_x;
         ball->y_vel = random_num_y;
-        P4OUT = player->score / 10;
-        P8OUT = 6;
-        P7OUT = 0b00000000;
-        P7OUT = 0b00000001;
-        P4OUT = player->score % 10;
-        P8OUT = 4;
-        P7OUT = 0b00000000;
-        P7OUT = 0b00000001;
+        ball_epoch++;
+        match_rally = 0;
+        display_score(player->score, 6, 4);
+    }
+}
+
+/* Writes n as a decimal string into str
+ */
+void number_to_string(unsigned long n, char *str)
+{
+    char digits[10];
+    int i = 0;
+    do
+    {
+        digits[i++] = '0' + n % 10;
+        n /= 10;
+    } while (n != 0);
+
+    while (i > 0)
+    {
+        *str++ = digits[--i];
+    }
+    *str = '\0';
+}
+
+/* Writes n as a decimal string into str, at most max
+ */
+void capped_number_to_string(unsigned long n, unsigned long max, char *str)
+{
+    number_to_string(n > max ? max : n, str);
+}
+
+/* Draws the match statistics from info flash: games won out of
+ * played for every AI, the longest rally, the fastest ball and
+ * the minutes played. Labels take the first 40 columns and the
+ * numbers are capped to fit the 7 characters after them, as
+ * draw_string can't go past the last column.
+ */
+void show_stats()
+{
+    char label[5];
+    char number[13];
+    int i, n;
+
+    write_zeros();
+    draw_string(0, 0, font_8x8, "#Stats");
+    draw_string(54, 0, font_8x8, "W/P");
+    for (i = 0; i < 4; i++)
+    {
+        for (n = 0; n < 4 && ai_names[i][n] != '\0'; n++)
+        {
+            label[n] = ai_names[i][n];
+        }
+        label[n] = '\0';
+        draw_string(0, i + 1, font_8x8, label);
+        capped_number_to_string(stats.won[i], 999, number);
+        for (n = 0; number[n] != '\0'; n++)
+            ;
+        number[n] = '/';
+        capped_number_to_string(stats.played[i], 999, number + n + 1);
+        draw_string(46, i + 1, font_8x8, number);
+    }
+    draw_string(0, 5, font_8x8, "Rally");
+    capped_number_to_string(stats.longest_rally, 9999999, number);
+    draw_string(46, 5, font_8x8, number);
+    draw_string(0, 6, font_8x8, "Speed");
+    capped_number_to_string(stats.max_speed, 9999999, number);
+    draw_string(46, 6, font_8x8, number);
+    draw_string(0, 7, font_8x8, "Mins");
+    capped_number_to_string(stats.play_seconds / 60, 9999999, number);
+    draw_string(46, 7, font_8x8, number);
+    PANEL_DUMP("stats");
+}
+
+/* Plays the game over music and draws who won
+ */
+void draw_game_over(struct paddle *player)
+{
+    play_music(3);
+    draw_string(15, 0, font_8x8, " ");
+    draw_string(77, 0, font_8x8, " ");
+    char gameover[] = "GAME OVER";
+    draw_string(15, 2, font_8x8, gameover);
+
+    if (player->score == 5)
+    {
+        char win[] = "YOU WIN!";
+        draw_string(20, 4, font_8x8, win);
+    }
+    else
+    {
+        char lose[] = ":(";
+        draw_string(40, 4, font_8x8, lose);
+        draw_string(0, 6, font_8x8, ai_names[ai_select]);
+        draw_string(62, 6, font_8x8, "WINS!");
     }
+    PANEL_DUMP("game_over");
 }
 
 /* Checks if the game is over
@@ -834,28 +1916,19 @@ void check_game_over(struct paddle *player, struct paddle *computer, struct ball
         {
             draw_string(77, 0, font_8x8, "G");
         }
+        if (game_point_flag == 1)
+        {
+            upload_music(game_point_notes, sizeof(game_point_notes) / sizeof(game_point_notes[0]));
+            play_music(SONG_UPLOADED);
+            set_music_tempo(GAME_POINT_TEMPO);
+            PANEL_DUMP("game_point");
+        }
     }
 
     if (player->score == 5 || computer->score == 5)
     {
-        play_music(3);
-        draw_string(15, 0, font_8x8, " ");
-        draw_string(77, 0, font_8x8, " ");
-        char gameover[] = "GAME OVER";
-        draw_string(15, 2, font_8x8, gameover);
-
-        if (player->score == 5)
-        {
-            char win[] = "YOU WIN!";
-            draw_string(20, 4, font_8x8, win);
-        }
-        else
-        {
-            char lose[] = ":(";
-            draw_string(40, 4, font_8x8, lose);
-            draw_string(0, 6, font_8x8, ai_names[ai_select]);
-            draw_string(62, 6, font_8x8, "WINS!");
-        }
+        set_music_tempo(16); // the game over song as written
+        draw_game_over(player);
         __delay_cycles(1000000);
         wait_for_player_input();
         start_animation();
@@ -873,6 +1946,16 @@ void check_game_over(struct paddle *player, struct paddle *computer, struct ball
 void send_byte(unsigned char char_to_write)
 {
     int n;
+#ifdef TELEMETRY
+    spi_bytes_sent++;
+#endif
+    FRAME_COST(COST_SPI_BYTES, 1);
+    FRAME_COST(COST_GPIO_WRITES, 24);
+    FRAME_COST(COST_BUS_CYCLES, SPI_BYTE_CYCLES);
+    FRAME_COST(COST_DELAY_CYCLES, 16);
+#ifdef SPI_TRACE
+    spi_trace_byte(char_to_write);
+#endif
     for (n = 8; n != 0; n--)
     {
         if (char_to_write & 0x80)
@@ -897,6 +1980,7 @@ void send_byte(unsigned char char_to_write)
 
 void draw_string(unsigned char column, unsigned char page, const unsigned char *font_adress, const char *str)
 {
+    SPI_SITE(SITE_STRING);
 
     unsigned int pos_array;                                                // Postion of character data in memory array
     unsigned char x, y, column_cnt, width_max;                             // temporary column and page adress, couloumn_cnt tand width_max are used to stay inside display area
@@ -928,6 +2012,9 @@ void draw_string(unsigned char column, unsigned char page, const unsigned char *
 
         P3OUT |= CD;
         P3OUT &= ~CS;
+#ifdef SPI_TRACE
+        spi_sites[SITE_STRING].transactions++;
+#endif
 
         while (*string != 0)
         {
@@ -982,6 +2069,7 @@ int get_player()
         draw_string(5, j * 2 + 1, font_8x8, ai_names[j]);
         draw_string(61, j * 2 + 1, font_8x8, difficulty[j]);
     }
+    PANEL_DUMP("player_menu");
     while (i < 10)
     {
         i++;
@@ -1016,6 +2104,7 @@ int get_ai()
         draw_string(5, j * 2 + 1, font_8x8, ai_names[j]);
         draw_string(61, j * 2 + 1, font_8x8, difficulty[j]);
     }
+    PANEL_DUMP("rival_menu");
     while (i < 10)
     {
         i++;
@@ -1034,111 +2123,1773 @@ int get_ai()
     return old_input;
 }
 
-void main(void)
+/* Fills in one render benchmark result from the timer
+ * ticks (SMCLK / 8) of BENCH_RUNS calls
+ */
+void bench_result(struct bench_result *result, const char *name, unsigned long ticks, unsigned int bytes)
 {
+    int i;
+    for (i = 0; i < 7 && name[i] != '\0'; i++)
+    {
+        result->name[i] = name[i];
+    }
+    result->name[i] = '\0';
+    result->cycles = ticks * 8 / BENCH_RUNS;
+    result->bytes = bytes;
+}
 
-    // Stop the watchdog timer so it doesn't reset our chip
-    WDTCTL = WDTPW + WDTHOLD;
-    P1DIR |= (BIT2 + BIT3 + BIT4);
-    srand(time(0));
-    init_MPD();
-    init_SPI();
-    __delay_cycles(5500); // Pause so everything has time to start up properly.
-    init_lcd();
-    init_ADC();
-    start_animation();
+/* Serves ball i of the pool from the center of the screen
+ * in a random direction
+ */
+void serve_pool_ball(int i)
+{
+    pool_x[i] = 47;
+    pool_y[i] = 28;
+    pool_x_vel[i] = (rand() % 2) ? 1 : -1;
+    pool_y_vel[i] = (rand() % 2) ? 1 : -1;
+}
 
-    struct paddle player;
-    struct paddle computer;
+/* Moves every ball in the pool and sorts them into buckets:
+ * only balls in the columns of the paddles (or past them)
+ * get a bit in pool_near and need a collision check.
+ */
+void move_pool(struct paddle *player, struct paddle *computer)
+{
+    int left_edge = player->x + player->width;
+    int right_edge = computer->x - 4;
+    int i;
+
+    pool_near = 0;
+    for (i = 0; i < pool_count; i++)
+    {
+        if (pool_y[i] <= 0 || pool_y[i] >= 59)
+        {
+            pool_y_vel[i] = -pool_y_vel[i];
+        }
+        pool_x[i] += pool_x_vel[i];
+        pool_y[i] += pool_y_vel[i];
+
+        if (pool_x[i] < left_edge || pool_x[i] > right_edge)
+        {
+            pool_near |= 1 << i;
+        }
+    }
+}
+
+/* Runs check_collision and update_score on the balls in
+ * pool_near only. A point adds a ball to the pool until
+ * it holds MAX_BALLS.
+ */
+void check_pool(struct paddle *player, struct paddle *computer)
+{
     struct ball ball;
-    set_up_game(&player, &computer, &ball);
+    unsigned int near = pool_near;
+    int i, scores;
 
-    char str[] = "PONG";
-    draw_string(35, 1, font_8x8, str);
-    char firstto5[] = "FIRST TO 5";
-    char wins[] = "WINS!";
-    draw_string(10, 3, font_8x8, firstto5);
-    draw_string(35, 4, font_8x8, wins);
-    draw_string(20, 6, font_8x8, "Twist to");
-    draw_string(32, 7, font_8x8, "START");
+    ball.size = 4;
+    for (i = 0; near != 0; i++, near >>= 1)
+    {
+        if (!(near & 1))
+        {
+            continue;
+        }
+        ball.x = pool_x[i];
+        ball.y = pool_y[i];
+        ball.x_vel = pool_x_vel[i];
+        ball.y_vel = pool_y_vel[i];
 
-    wait_for_player_input();
-    start_animation();
-    int player_select = -1;
-    P2DIR &= ~BIT1; // Set P2.1 as input
-    P2REN |= BIT1;  // Enable pull-up/down resistor for P2.1
-    P2OUT |= BIT1;  // Configure pull-up resistor for P2.1
+        scores = player->score + computer->score;
+        check_collision(&ball, player, computer);
+        update_score(player, computer, &ball);
 
-    if (!(P2IN & BIT1))
+        pool_x[i] = ball.x;
+        pool_y[i] = ball.y;
+        pool_x_vel[i] = ball.x_vel;
+        pool_y_vel[i] = ball.y_vel;
+
+        if (scores != player->score + computer->score && pool_count < MAX_BALLS)
+        {
+            serve_pool_ball(pool_count++);
+        }
+    }
+}
+
+/* Copies the ball that will reach the paddle first into ball,
+ * so the AI functions can play against the pool. Returns 0
+ * if no ball is coming towards the paddle.
+ * When the paddle switches to another ball, or its ball comes
+ * back after a hit, only this paddle's prediction is dropped.
+ * A wall bounce keeps it, predict_intercept already followed it.
+ */
+int pool_target(struct paddle *paddle, struct ball *ball)
+{
+    int i, dist;
+    int best = -1;
+    int best_dist = 200;
+
+    for (i = 0; i < pool_count; i++)
     {
-        player_select = get_player();
-        start_animation();
+        if (paddle->x > 50)
+        {
+            dist = pool_x_vel[i] > 0 ? paddle->x - pool_x[i] : 200;
+        }
+        else
+        {
+            dist = pool_x_vel[i] < 0 ? pool_x[i] - paddle->x : 200;
+        }
+        if (dist < best_dist)
+        {
+            best_dist = dist;
+            best = i;
+        }
     }
-    else
+    if (best < 0)
+    {
+        return 0;
+    }
+    if (paddle->ai.pool_ball != best || ball->x_vel != pool_x_vel[best])
     {
-        player_select = -1;
+        paddle->ai.pool_ball = best;
+        paddle->ai.epoch = -1; // new target, this AI has to predict again
     }
+    ball->x = pool_x[best];
+    ball->y = pool_y[best];
+    ball->size = 4;
+    ball->x_vel = pool_x_vel[best];
+    ball->y_vel = pool_y_vel[best];
+    return 1;
+}
 
-    void (*ai_functions[4])(struct paddle *, struct ball *) = {
-        move_ai_predictive,
-        move_ai_edge_hitter,
-        move_ai_raveel,
-        move_ai_middle_hitter,
-    };
+/* Shows the average frame time for each number of balls
+ * that was in play during the last multi-ball game
+ */
+void show_pool_results()
+{
+    char number[11];
+    int i;
 
-    ai_select = get_ai();
-    start_animation();
-    int isPaused = 0;
+    write_zeros();
+    draw_string(0, 0, font_8x8, "Balls Cycles");
+    for (i = 0; i < MAX_BALLS; i++)
+    {
+        number[0] = '1' + i;
+        number[1] = '\0';
+        draw_string(16, i + 2, font_8x8, number);
+        number_to_string(pool_frames[i] ? pool_frame_ticks[i] * 8 / pool_frames[i] : 0, number);
+        draw_string(48, i + 2, font_8x8, number);
+    }
+}
 
-    while (1)
+/* Multi-ball game. Starts with one ball and serves an extra
+ * one after every point, up to MAX_BALLS, until one side has 5.
+ * Every frame is timed with Timer A1 (SMCLK / 8) and filed under
+ * the ball count, the results are shown at game over and the
+ * knob goes back to a regular game.
+ */
+void run_multi_ball(struct paddle *player, struct paddle *computer, int player_select)
+{
+    struct ball player_target = {0};
+    struct ball computer_target = {0};
+    unsigned int start;
+    int i;
+
+    set_up_game(player, computer, &player_target);
+    init_MPD();
+    pool_count = 1;
+    serve_pool_ball(0);
+    for (i = 0; i < MAX_BALLS; i++)
+    {
+        pool_frame_ticks[i] = 0;
+        pool_frames[i] = 0;
+    }
+    TA1CTL = TASSEL_2 + MC_2 + ID_3 + TACLR; // SMCLK / 8, continuous mode
+
+    while (player->score < 5 && computer->score < 5)
     {
+        int balls = pool_count;
+        start = TA1R;
 
         count++;
-        set_ball_speed(&ball);
+        set_ball_speed(&player_target);
         char adc_position = get_adc_position();
-        clear_rectangle(player.x, player.y, player.width, player.height);
-        clear_rectangle(computer.x, computer.y, computer.width, computer.height);
-        clear_ball(ball.x, ball.y);
-        if (isPaused == 0)
+        clear_rectangle(player->x, player->y, player->width, player->height);
+        clear_rectangle(computer->x, computer->y, computer->width, computer->height);
+        for (i = 0; i < pool_count; i++)
         {
-            if (!(P2IN & BIT1))
-            {
-                isPaused = 1;
-                x_left = 10;
-                x_right = 85;
-                pause_animation();
+            clear_ball(pool_x[i], pool_y[i]);
+        }
 
-                while (isPaused)
-                {
-                    draw_string(20, 5, font_8x8, "Press to");
-                    draw_string(32, 6, font_8x8, "RESUME");
-                    __delay_cycles(100000);
-                    if (!(P2IN & BIT1))
-                    {
-                        clear_animation();
-                        draw_string(20, 5, font_8x8, "        ");
-                        draw_string(32, 6, font_8x8, "      ");
-                        isPaused = 0;
-                        break;
-                    }
-                }
-            }
-            if (player_select == -1)
-            {
-                move_player(&player, adc_position);
-            }
-            else
-            {
-                ai_functions[player_select](&player, &ball);
-            }
-            ai_functions[ai_select](&computer, &ball);
-            move_ball(&ball);
-            check_collision(&ball, &player, &computer);
-            update_score(&player, &computer, &ball);
-            check_game_over(&player, &computer, &ball);
+        if (player_select == -1)
+        {
+            move_player(player, adc_position);
         }
-        draw_rectangle(player.x, player.y, player.width, player.height);
-        draw_rectangle(computer.x, computer.y, computer.width, computer.height);
-        draw_ball(ball.x, ball.y);
+        else if (pool_target(player, &player_target))
+        {
+            ai_functions[player_select](player, &player_target);
+        }
+        if (pool_target(computer, &computer_target))
+        {
+            ai_functions[ai_select](computer, &computer_target);
+        }
+        move_pool(player, computer);
+        check_pool(player, computer);
+
+        draw_rectangle(player->x, player->y, player->width, player->height);
+        draw_rectangle(computer->x, computer->y, computer->width, computer->height);
+        for (i = 0; i < pool_count; i++)
+        {
+            draw_ball(pool_x[i], pool_y[i]);
+        }
+
+        pool_frame_ticks[balls - 1] += (unsigned int)(TA1R - start);
+        pool_frames[balls - 1]++;
+    }
+
+    play_music(3);
+    show_pool_results();
+    draw_string(15, 7, font_8x8, "GAME OVER");
+    __delay_cycles(1000000);
+    wait_for_player_input();
+    start_animation();
+}
+
+/* Plays one AI vs AI game without drawing anything, as fast
+ * as the core allows. Returns 1 if the left AI won, -1 if the
+ * right AI won and 0 for a draw (a game that is still going
+ * after TURBO_MAX_STEPS)
+ */
+int play_turbo_game(int left_ai, int right_ai)
+{
+    struct paddle player;
+    struct paddle computer;
+    struct ball ball;
+    unsigned int start;
+    unsigned int steps = 0;
+
+    set_up_game(&player, &computer, &ball);
+    while (player.score < 5 && computer.score < 5 && steps < TURBO_MAX_STEPS)
+    {
+        start = TA1R;
+        count++;
+        set_ball_speed(&ball);
+        ai_functions[left_ai](&player, &ball);
+        ai_functions[right_ai](&computer, &ball);
+        move_ball(&ball);
+        check_collision(&ball, &player, &computer);
+        update_score(&player, &computer, &ball);
+        turbo_cycles += (unsigned int)(TA1R - start);
+        steps++;
+    }
+    turbo_steps += steps;
+
+    if (player.score == 5)
+    {
+        return 1;
+    }
+    return computer.score == 5 ? -1 : 0;
+}
+
+/* Shows the tournament results. Each row is the left AI and
+ * each column the right AI, with two digits: how many of the
+ * TURBO_GAMES the left AI won and how many it lost, the rest
+ * were draws. Below is the average cost of one game step in
+ * cycles.
+ */
+void show_turbo_results()
+{
+    char initials[] = "MDRA";
+    char cell[3] = {0};
+    char number[11];
+    int left, right;
+
+    write_zeros();
+    draw_string(0, 0, font_8x8, "L\\R");
+    for (left = 0; left < 4; left++)
+    {
+        cell[0] = initials[left];
+        cell[1] = '\0';
+        draw_string(0, left + 1, font_8x8, cell);
+        draw_string(28 + left * 20, 0, font_8x8, cell);
+        for (right = 0; right < 4; right++)
+        {
+            cell[0] = '0' + turbo_wins[left][right];
+            cell[1] = '0' + turbo_losses[left][right];
+            draw_string(24 + right * 20, left + 1, font_8x8, cell);
+        }
+    }
+
+    draw_string(0, 5, font_8x8, "Won,lost");
+    draw_string(0, 6, font_8x8, "Cycles/step");
+    number_to_string(turbo_steps ? turbo_cycles / turbo_steps : 0, number);
+    draw_string(0, 7, font_8x8, number);
+}
+
+/* Runs every AI against every AI (16 pairings) TURBO_GAMES
+ * times each, then shows the results until the knob is turned
+ */
+void run_turbo_tournament()
+{
+    int left, right, game, result;
+
+    headless_mode = 1;
+    turbo_cycles = 0;
+    turbo_steps = 0;
+    init_cycle_timer();
+    draw_string(20, 3, font_8x8, "TURBO...");
+
+    for (left = 0; left < 4; left++)
+    {
+        for (right = 0; right < 4; right++)
+        {
+            turbo_wins[left][right] = 0;
+            turbo_losses[left][right] = 0;
+            for (game = 0; game < TURBO_GAMES; game++)
+            {
+                result = play_turbo_game(left, right);
+                turbo_wins[left][right] += result > 0;
+                turbo_losses[left][right] += result < 0;
+            }
+        }
+    }
+
+    headless_mode = 0;
+    show_turbo_results();
+    wait_for_player_input();
+    start_animation();
+}
+
+/* Initializes USCI A1 as a 9600 baud UART for the console link
+ * TXD = P4.4
+ * RXD = P4.5
+ * Received bytes are queued by USCI_A1_ISR
+ * P4.4 and P4.5 are also the eZ-FET back-channel UART, which
+ * TELEMETRY, SPI_TRACE and FRAME_BENCH report on, so those builds
+ * keep the UART but never link (LINK_ENABLED)
+ */
+void init_link()
+{
+    P4SEL |= BIT4 + BIT5;
+    UCA1CTL1 |= UCSWRST;          // hold the UART in reset while configuring
+    UCA1CTL1 |= UCSSEL_2;         // SMCLK, 1MHz
+    UCA1BR0 = 104;                // 1MHz / 9600
+    UCA1BR1 = 0;
+    UCA1MCTL = UCBRS_1 + UCBRF_0; // modulation for 9600 baud
+    UCA1CTL1 &= ~UCSWRST;
+    UCA1IE |= UCRXIE;
+    __enable_interrupt();
+}
+
+void link_send(unsigned char byte)
+{
+    while (!(UCA1IFG & UCTXIFG))
+        ;
+    UCA1TXBUF = byte;
+}
+
+/* Returns the next received byte, or -1 if there is none
+ */
+int link_receive()
+{
+    int byte;
+    if (link_rx_tail == link_rx_head)
+    {
+        return -1;
+    }
+    byte = link_rx[link_rx_tail & (LINK_RX_SIZE - 1)];
+    link_rx_tail++;
+    return byte;
+}
+
+/* Waits for the knob to be turned (like wait_for_player_input)
+ * while listening for another console on the link.
+ * Returns the side this console plays in a linked game:
+ * 0 = left paddle (turned the knob first), 1 = right paddle,
+ * or -1 if no other console answered. Returns SHOW_STATS if the
+ * debug button was pressed and let go before the knob turned
+ * (holding it while turning is left for main to see).
+ */
+int wait_for_player_or_link()
+{
+    const int dead_zone = 5;
+    char old = get_adc_position();
+    char new = get_adc_position();
+    int pressed = 0;
+    int wait;
+
+    link_rx_tail = link_rx_head;
+    while (new + dead_zone >= old && new - dead_zone <= old)
+    {
+        if (LINK_ENABLED && link_receive() == LINK_HELLO)
+        {
+            link_send(LINK_ACK);
+            return 1;
+        }
+        if (!(P2IN & BIT1))
+        {
+            pressed = 1;
+        }
+        else if (pressed)
+        {
+            return SHOW_STATS;
+        }
+        new = get_adc_position();
+    }
+
+    if (!LINK_ENABLED)
+    {
+        return -1;
+    }
+    link_send(LINK_HELLO);
+    for (wait = 0; wait < 100; wait++)
+    {
+        if (link_receive() == LINK_ACK)
+        {
+            return 0;
+        }
+        __delay_cycles(1000);
+    }
+    return -1;
+}
+
+/* Saves the complete simulation state at the start of a frame
+ */
+void save_link_state(unsigned int frame, struct paddle *player, struct paddle *computer, struct ball *ball)
+{
+    struct link_state *state = &link_states[frame & (LINK_STATES - 1)];
+    state->player = *player;
+    state->computer = *computer;
+    state->ball = *ball;
+    state->count = count;
+    state->speed_flag = speed_flag;
+    state->seed = game_seed;
+}
+
+void load_link_state(unsigned int frame, struct paddle *player, struct paddle *computer, struct ball *ball)
+{
+    struct link_state *state = &link_states[frame & (LINK_STATES - 1)];
+    *player = state->player;
+    *computer = state->computer;
+    *ball = state->ball;
+    count = state->count;
+    speed_flag = state->speed_flag;
+    game_seed = state->seed;
+}
+
+/* Runs one frame of a linked game. Only the paddle inputs
+ * come from outside, everything else is deterministic.
+ */
+void link_step(struct paddle *player, struct paddle *computer, struct ball *ball, int left_y, int right_y)
+{
+    count++;
+    set_ball_speed(ball);
+    move_player(player, left_y);
+    move_player(computer, right_y);
+    move_ball(ball);
+    check_collision(ball, player, computer);
+    update_score(player, computer, ball);
+}
+
+/* Sends the local input of a frame: the frame number with
+ * the top bit set, then the paddle y (always below 0x80)
+ */
+void link_send_input(unsigned int frame)
+{
+    link_send(0x80 | (frame & 0x7F));
+    link_send(link_local[frame & (LINK_INPUTS - 1)]);
+}
+
+/* Reads the inputs the other console sent. Inputs arrive in order
+ * and only the next missing frame is accepted. Returns the first
+ * frame that was simulated with a wrong guess, or 'frame' if none.
+ */
+unsigned int link_poll(unsigned int frame)
+{
+    unsigned int rollback = frame;
+    int byte;
+
+    while ((byte = link_receive()) >= 0)
+    {
+        if (byte & 0x80)
+        {
+            link_rx_frame = byte & 0x7F;
+            continue;
+        }
+        if (link_rx_frame < 0)
+        {
+            continue;
+        }
+
+        unsigned int next = link_remote_frame + 1;
+        if ((int)(next & 0x7F) == link_rx_frame)
+        {
+            unsigned char *input = &link_remote[next & (LINK_INPUTS - 1)];
+            if (next < frame && *input != byte && next < rollback)
+            {
+                rollback = next;
+            }
+            *input = byte;
+            link_remote_frame = next;
+        }
+        link_rx_frame = -1;
+    }
+    return rollback;
+}
+
+/* Plays a game against another console. Both consoles run the
+ * same simulation; only paddle inputs go over the link. When the
+ * other console's input for a frame is late, its last input is
+ * used instead, and once the real one arrives the game is rolled
+ * back to that frame and simulated again. Local input is never
+ * held back by the link, unless the other console falls more than
+ * LINK_STATES - 1 frames behind. The game ends at the first frame
+ * that reaches 5 points, once every input before it has arrived,
+ * so both consoles end on the same frame.
+ */
+void run_link_game(int side)
+{
+    struct paddle player;
+    struct paddle computer;
+    struct ball ball;
+    unsigned int frame = 0; // next frame to read local input for
+    unsigned int at = 0;    // frame the simulation is at, behind 'frame' once a score reaches 5
+    unsigned int rollback, f;
+    int shown_player = 0, shown_computer = 0;
+    int player_shown = PADDLE_HIDDEN, computer_shown = PADDLE_HIDDEN; // paddle y's on the panel
+
+    game_seed = LINK_SEED;
+    set_up_game(&player, &computer, &ball);
+    init_MPD();
+    link_remote_frame = -1;
+    link_rx_frame = -1;
+    link_remote[LINK_INPUTS - 1] = 28; // guess for frame 0
+
+    while (1)
+    {
+        clear_ball(ball.x, ball.y);
+        hide_paddle_under_ball(ball.x, &player, &player_shown);
+        hide_paddle_under_ball(ball.x, &computer, &computer_shown);
+
+        // Wait for the other console if it is too far behind, or
+        // for its inputs up to a frame that reached 5 points
+        rollback = frame;
+        while ((int)(frame - link_remote_frame) >= LINK_STATES - 1 ||
+               ((player.score == 5 || computer.score == 5) && (int)(at - 1 - link_remote_frame) > 0))
+        {
+            for (f = frame > LINK_STATES - 1 ? frame - (LINK_STATES - 1) : 0; f != frame; f++)
+            {
+                link_send_input(f);
+            }
+            f = link_poll(frame);
+            if (f < rollback)
+            {
+                rollback = f;
+            }
+            __delay_cycles(2000);
+        }
+
+        // Re-simulate from the first frame that had a wrong guess,
+        // stopping early if a score reaches 5 on the way
+        f = link_poll(frame);
+        if (f < rollback)
+        {
+            rollback = f;
+        }
+        if (rollback < at)
+        {
+            headless_mode = 1;
+            load_link_state(rollback, &player, &computer, &ball);
+            for (at = rollback; at != frame && player.score != 5 && computer.score != 5; at++)
+            {
+                save_link_state(at, &player, &computer, &ball);
+                if ((int)(at - link_remote_frame) > 0)
+                {
+                    link_remote[at & (LINK_INPUTS - 1)] = link_remote[link_remote_frame & (LINK_INPUTS - 1)];
+                }
+                link_step(&player, &computer, &ball,
+                          side == 0 ? link_local[at & (LINK_INPUTS - 1)] : link_remote[at & (LINK_INPUTS - 1)],
+                          side == 0 ? link_remote[at & (LINK_INPUTS - 1)] : link_local[at & (LINK_INPUTS - 1)]);
+            }
+            headless_mode = 0;
+        }
+
+        if (player.score != 5 && computer.score != 5)
+        {
+            link_local[frame & (LINK_INPUTS - 1)] = get_adc_position();
+            link_send_input(frame);
+
+            // Guess the other console's input if it has not arrived yet
+            save_link_state(frame, &player, &computer, &ball);
+            if ((int)(frame - link_remote_frame) > 0)
+            {
+                link_remote[frame & (LINK_INPUTS - 1)] = link_remote[link_remote_frame & (LINK_INPUTS - 1)];
+            }
+            link_step(&player, &computer, &ball,
+                      side == 0 ? link_local[frame & (LINK_INPUTS - 1)] : link_remote[frame & (LINK_INPUTS - 1)],
+                      side == 0 ? link_remote[frame & (LINK_INPUTS - 1)] : link_local[frame & (LINK_INPUTS - 1)]);
+            at = ++frame;
+        }
+
+        // A rollback can change the score, keep the display in sync
+        if (shown_player != player.score || shown_computer != computer.score)
+        {
+            display_score(player.score, 6, 4);
+            display_score(computer.score, 2, 0);
+            shown_player = player.score;
+            shown_computer = computer.score;
+        }
+
+        show_paddle(&player, &player_shown);
+        show_paddle(&computer, &computer_shown);
+        draw_ball(ball.x, ball.y);
+
+        // Only end the game on a frame both consoles agree on
+        if ((player.score == 5 || computer.score == 5) && (int)(at - 1 - link_remote_frame) <= 0)
+        {
+            play_music(3);
+            draw_string(15, 2, font_8x8, "GAME OVER");
+            if ((player.score == 5) == (side == 0))
+            {
+                draw_string(20, 4, font_8x8, "YOU WIN!");
+            }
+            else
+            {
+                draw_string(40, 4, font_8x8, ":(");
+            }
+
+            // The other console may still be missing our last inputs
+            for (f = frame > LINK_STATES - 1 ? frame - (LINK_STATES - 1) : 0; f != frame; f++)
+            {
+                link_send_input(f);
+            }
+            __delay_cycles(1000000);
+            return;
+        }
+    }
+}
+
+#ifdef TELEMETRY
+/* Sends one telemetry record for the frame that just ended.
+ * DMA channel 0 feeds the UART, so this only fills the record and
+ * starts the transfer. If the previous record is still going out
+ * (DMA0 busy, or its last byte still in UCA1TXBUF) the new one is
+ * dropped instead of waiting. The DMA has read the whole record by
+ * then, so one buffer is enough.
+ */
+void send_telemetry(struct paddle *player, struct paddle *computer, struct ball *ball, int computer_old_y, unsigned int frame_cycles)
+{
+    struct telemetry_record *record = &telemetry_record;
+    unsigned char *bytes = (unsigned char *)record;
+    unsigned char sum = 0;
+    int i;
+
+    telemetry_frame++;
+    if ((DMA0CTL & DMAEN) || !(UCA1IFG & UCTXIFG))
+    {
+        telemetry_dropped++;
+        spi_bytes_sent = 0;
+        return;
+    }
+
+    record->sync = TELEMETRY_SYNC;
+    record->frame = telemetry_frame;
+    record->ball_x = ball->x;
+    record->ball_y = ball->y;
+    record->ball_x_vel = ball->x_vel;
+    record->ball_y_vel = ball->y_vel;
+    record->player_y = player->y;
+    record->computer_y = computer->y;
+    record->scores = (player->score << 4) | computer->score;
+    record->ai_move = computer->y - computer_old_y;
+    record->frame_cycles = frame_cycles;
+    record->spi_bytes = spi_bytes_sent;
+    record->ai_select = ai_select;
+    for (i = 1; i < TELEMETRY_RECORD_SIZE - 1; i++)
+    {
+        sum += bytes[i];
+    }
+    record->checksum = sum;
+    spi_bytes_sent = 0;
+
+    // The first byte goes out by hand, every TX interrupt flag
+    // after it triggers the DMA for the next one
+    DMACTL0 = (DMACTL0 & 0xFF00) | DMA0TSEL_21; // UCA1TXIFG
+    __data16_write_addr((unsigned short)&DMA0SA, (unsigned long)&bytes[1]);
+    __data16_write_addr((unsigned short)&DMA0DA, (unsigned long)&UCA1TXBUF);
+    DMA0SZ = TELEMETRY_RECORD_SIZE - 1;
+    DMA0CTL = DMADT_0 + DMASRCINCR_3 + DMADSTINCR_0 + DMASBDB + DMAEN;
+    UCA1TXBUF = bytes[0];
+}
+#endif
+
+/* Times the display primitives on the board with Timer A1 and shows
+ * cycles per call and bytes per second, four results per screen
+ * (turn the knob for the next screen). Selected by holding the
+ * debug button at power-on.
+ */
+void run_render_benchmark()
+{
+    struct bench_result results[BENCH_TESTS];
+    unsigned char data[64];
+    unsigned int start;
+    unsigned long ticks;
+    char number[11];
+    int n = 0;
+    int run, y, i;
+
+    TA1CTL = TASSEL_2 + MC_2 + ID_3 + TACLR; // SMCLK / 8, continuous mode
+
+    BENCH(write_zeros());
+    bench_result(&results[n++], "zeros", ticks, 8 * (3 + 102));
+    BENCH(write_ones());
+    bench_result(&results[n++], "full", ticks, 8 * (3 + 102));
+
+    // Every alignment of a paddle sized rectangle inside a page
+    for (y = 0; y < 8; y++)
+    {
+        int bytes = ((y + 16) / 8 - y / 8 + 1) * (3 + 7);
+        BENCH(draw_rectangle(10, 8 + y, 7, 16));
+        bench_result(&results[n], "rect 0", ticks, bytes);
+        results[n++].name[5] = '0' + y;
+        BENCH(clear_rectangle(10, 8 + y, 7, 16));
+        bench_result(&results[n], "clr 0", ticks, bytes);
+        results[n++].name[4] = '0' + y;
+    }
+
+    BENCH(move_paddle(10, 8, 9, 7, 16));
+    bench_result(&results[n++], "move 1", ticks, 2 * (3 + 7));
+    BENCH(draw_ball(47, 28));
+    bench_result(&results[n++], "ball", ticks, 2 * (3 + 4));
+    BENCH(draw_string(0, 0, font_8x8, "0123456789ABC"));
+    bench_result(&results[n++], "string", ticks, 3 + 13 * 8);
+
+    // Raw SPI, the data is refilled outside the timing
+    ticks = 0;
+    P3OUT |= CD; // set for data
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        for (i = 0; i < (int)sizeof(data); i++)
+        {
+            data[i] = 0x55;
+        }
+        start = TA1R;
+        spi_IO(data, sizeof(data));
+        ticks += (unsigned int)(TA1R - start);
+    }
+    bench_result(&results[n++], "spi 64", ticks, sizeof(data));
+
+    for (i = 0; i < n; i++)
+    {
+        if (i % 4 == 0)
+        {
+            if (i != 0)
+            {
+                wait_for_player_input();
+            }
+            write_zeros();
+        }
+        draw_string(0, (i % 4) * 2, font_8x8, results[i].name);
+        number_to_string(results[i].cycles, number);
+        draw_string(48, (i % 4) * 2, font_8x8, number);
+        draw_string(8, (i % 4) * 2 + 1, font_8x8, "B/s");
+        number_to_string(results[i].cycles ? results[i].bytes * MCLK_HZ / results[i].cycles : 0, number);
+        draw_string(48, (i % 4) * 2 + 1, font_8x8, number);
+    }
+    wait_for_player_input();
+    write_zeros();
+}
+
+#if defined(SPI_TRACE) || defined(FRAME_BENCH)
+void uart_print(const char *str)
+{
+    while (*str != '\0')
+    {
+        trace_send(*str++);
+    }
+}
+
+void uart_print_number(unsigned long n)
+{
+    char number[11];
+    number_to_string(n, number);
+    uart_print(number);
+    trace_send(',');
+}
+#endif
+
+#ifdef FRAME_BENCH
+/* Plays n frames of the main loop body with FRAME_BENCH_AI on
+ * both paddles, adding their costs to frame_cost. A game that
+ * ends shows the game over screen and starts again instead of
+ * waiting for the knob.
+ */
+void frame_bench_run(struct paddle *player, struct paddle *computer, struct ball *ball, int n)
+{
+    unsigned int start;
+
+    while (n-- > 0)
+    {
+        start = TA1R;
+        count++;
+        set_ball_speed(ball);
+        clear_ball(ball->x, ball->y);
+        hide_paddle_under_ball(ball->x, player, &frame_bench_shown[0]);
+        hide_paddle_under_ball(ball->x, computer, &frame_bench_shown[1]);
+        ai_functions[FRAME_BENCH_AI](player, ball);
+        ai_functions[FRAME_BENCH_AI](computer, ball);
+        move_ball(ball);
+        check_collision(ball, player, computer);
+        update_score(player, computer, ball);
+        if (player->score == 5 || computer->score == 5)
+        {
+            // The text goes over the paddles' columns, show_paddle
+            // draws them whole again in the new game
+            hide_paddle(player, &frame_bench_shown[0]);
+            hide_paddle(computer, &frame_bench_shown[1]);
+            draw_game_over(player);
+            set_up_game(player, computer, ball);
+        }
+        else
+        {
+            check_game_over(player, computer, ball);
+        }
+        show_paddle(player, &frame_bench_shown[0]);
+        show_paddle(computer, &frame_bench_shown[1]);
+        draw_ball(ball->x, ball->y);
+        frame_cost[COST_CYCLES] += (unsigned int)(TA1R - start) * 8UL;
+        frame_bench_frames++;
+    }
+}
+
+/* Plays one scenario from a fixed seed, leaving its totals
+ * in frame_cost and frame_bench_frames
+ */
+void frame_bench_scenario(int scenario)
+{
+    struct paddle player;
+    struct paddle computer;
+    struct ball ball;
+    unsigned int start;
+    int i;
+
+    for (i = 0; i < COSTS; i++)
+    {
+        frame_cost[i] = 0;
+    }
+    frame_bench_frames = 0;
+    srand(FRAME_BENCH_SEED);
+    game_seed = FRAME_BENCH_SEED;
+    write_zeros();
+    set_up_game(&player, &computer, &ball);
+    frame_bench_shown[0] = PADDLE_HIDDEN;
+    frame_bench_shown[1] = PADDLE_HIDDEN;
+
+    switch (scenario)
+    {
+    case 0: // rally from the first serve
+        frame_bench_run(&player, &computer, &ball, FRAME_BENCH_FRAMES);
+        break;
+    case 1: // fast ball, as after four speed-ups
+        ball.x_vel = 5;
+        ball.y_vel = 3;
+        frame_bench_run(&player, &computer, &ball, FRAME_BENCH_FRAMES);
+        break;
+    case 2: // four points, each followed by a serve and a short rally
+        for (i = 0; i < 4; i++)
+        {
+            ball.x = (i % 2) ? -3 : 96; // one frame from going out
+            ball.x_vel = (i % 2) ? -1 : 1;
+            frame_bench_run(&player, &computer, &ball, FRAME_BENCH_FRAMES / 4);
+        }
+        break;
+    case 3: // pause and resume halfway through a rally
+        frame_bench_run(&player, &computer, &ball, FRAME_BENCH_FRAMES / 2);
+        start = TA1R;
+        x_left = 10;
+        x_right = 85;
+        hide_paddle(&player, &frame_bench_shown[0]);
+        hide_paddle(&computer, &frame_bench_shown[1]);
+        pause_animation();
+        draw_string(20, 5, font_8x8, "Press to");
+        draw_string(32, 6, font_8x8, "RESUME");
+        clear_animation();
+        draw_string(20, 5, font_8x8, "        ");
+        draw_string(32, 6, font_8x8, "      ");
+        frame_cost[COST_CYCLES] += (unsigned int)(TA1R - start) * 8UL;
+        frame_bench_frames++;
+        frame_bench_run(&player, &computer, &ball, FRAME_BENCH_FRAMES / 2);
+        break;
+    default: // game point for both, played until the game over screen
+        player.score = 4;
+        computer.score = 4;
+        while (player.score != 0 && frame_bench_frames < FRAME_BENCH_FRAMES)
+        {
+            frame_bench_run(&player, &computer, &ball, 1);
+        }
+        break;
+    }
+}
+
+/* Plays every scenario and sends its per frame costs over the
+ * back-channel UART as one line of JSON:
+ * {"tolerance":10,"scenarios":[{"name":"rally","frames":200,
+ *  "spi_bytes":..,...,"cycles":..,"regressed":0},...],"pass":1}
+ * A metric regresses when it is more than FRAME_BENCH_TOLERANCE
+ * percent above frame_bench_baseline. PASS or FAIL is shown per
+ * scenario until the knob is turned, then the game boots as usual.
+ */
+void run_frame_bench()
+{
+    unsigned long cost[FRAME_BENCH_SCENARIOS][COSTS];
+    unsigned int frames[FRAME_BENCH_SCENARIOS];
+    int regressed[FRAME_BENCH_SCENARIOS];
+    int pass = 1;
+    int scenario, i;
+
+    TA1CTL = TASSEL_2 + MC_2 + ID_3 + TACLR; // SMCLK / 8, continuous mode
+
+    for (scenario = 0; scenario < FRAME_BENCH_SCENARIOS; scenario++)
+    {
+        frame_bench_scenario(scenario);
+        frames[scenario] = frame_bench_frames;
+        regressed[scenario] = 0;
+        for (i = 0; i < COSTS; i++)
+        {
+            unsigned long baseline = frame_bench_baseline[scenario][i];
+            cost[scenario][i] = frame_cost[i] / frame_bench_frames;
+            if (baseline != NO_BASELINE && cost[scenario][i] * 100 > baseline * (100 + FRAME_BENCH_TOLERANCE))
+            {
+                regressed[scenario] = 1;
+                pass = 0;
+            }
+        }
+    }
+
+    uart_print("{\"tolerance\":");
+    uart_print_number(FRAME_BENCH_TOLERANCE);
+    uart_print("\"scenarios\":[");
+    for (scenario = 0; scenario < FRAME_BENCH_SCENARIOS; scenario++)
+    {
+        uart_print(scenario ? ",{\"name\":\"" : "{\"name\":\"");
+        uart_print(scenario_names[scenario]);
+        uart_print("\",\"frames\":");
+        uart_print_number(frames[scenario]);
+        for (i = 0; i < COSTS; i++)
+        {
+            trace_send('"');
+            uart_print(cost_names[i]);
+            uart_print("\":");
+            uart_print_number(cost[scenario][i]);
+        }
+        uart_print(regressed[scenario] ? "\"regressed\":1}" : "\"regressed\":0}");
+    }
+    uart_print(pass ? "],\"pass\":1}\r\n" : "],\"pass\":0}\r\n");
+
+    write_zeros();
+    for (scenario = 0; scenario < FRAME_BENCH_SCENARIOS; scenario++)
+    {
+        draw_string(0, scenario, font_8x8, scenario_names[scenario]);
+        draw_string(64, scenario, font_8x8, regressed[scenario] ? "FAIL" : "PASS");
+    }
+    draw_string(0, 7, font_8x8, pass ? "BENCH PASS" : "BENCH FAIL");
+    wait_for_player_input();
+    write_zeros();
+}
+#endif
+
+#ifdef SPI_TRACE
+/* Sends the LCD bus trace over the back-channel UART as CSV,
+ * sites with the most wasted bytes first, then the frame totals
+ */
+void spi_trace_report()
+{
+    int order[SITES];
+    int i, j, site;
+
+    for (i = 0; i < SITES; i++)
+    {
+        order[i] = i;
+    }
+    for (i = 0; i < SITES; i++)
+    {
+        for (j = i + 1; j < SITES; j++)
+        {
+            struct spi_site_stats *a = &spi_sites[order[i]];
+            struct spi_site_stats *b = &spi_sites[order[j]];
+            if (b->same_data + b->same_address + b->outside > a->same_data + a->same_address + a->outside)
+            {
+                site = order[i];
+                order[i] = order[j];
+                order[j] = site;
+            }
+        }
+    }
+
+    uart_print("site,transactions,commands,data,same_data,same_address,outside,\r\n");
+    for (i = 0; i < SITES; i++)
+    {
+        struct spi_site_stats *stats = &spi_sites[order[i]];
+        uart_print(site_names[order[i]]);
+        trace_send(',');
+        uart_print_number(stats->transactions);
+        uart_print_number(stats->commands);
+        uart_print_number(stats->data);
+        uart_print_number(stats->same_data);
+        uart_print_number(stats->same_address);
+        uart_print_number(stats->outside);
+        uart_print("\r\n");
+    }
+    uart_print("frame,bytes,wasted,max_bytes,max_wasted,\r\nlast,");
+    uart_print_number(last_frame_bytes);
+    uart_print_number(last_frame_waste);
+    uart_print_number(frame_bytes_max);
+    uart_print_number(frame_waste_max);
+    uart_print("\r\n");
+}
+#endif
+
+/* Erases one 128 byte segment of info flash
+ */
+void flash_erase_segment(unsigned char *segment)
+{
+    FCTL3 = FWKEY;         // Clear LOCK
+    FCTL1 = FWKEY + ERASE; // Segment erase
+    *segment = 0;          // Dummy write starts the erase
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+}
+
+/* Programs bytes into erased flash
+ */
+void flash_write(unsigned char *dest, const unsigned char *src, int bytes)
+{
+    FCTL3 = FWKEY;       // Clear LOCK
+    FCTL1 = FWKEY + WRT; // Byte write
+    while (bytes-- > 0)
+    {
+        *dest++ = *src++;
+    }
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+}
+
+unsigned char snapshot_checksum(const struct snapshot *snap)
+{
+    const unsigned char *bytes = (const unsigned char *)snap;
+    unsigned char sum = 0x5A;
+    int i;
+    for (i = 0; i < (int)sizeof(struct snapshot); i++)
+    {
+        sum += bytes[i];
+    }
+    return sum - snap->checksum;
+}
+
+/* Returns the newest valid snapshot in info flash, or 0
+ */
+const struct snapshot *find_snapshot()
+{
+    const struct snapshot *best = 0;
+    unsigned int i, j;
+    for (i = 0; i < 2; i++)
+    {
+        const struct snapshot *snap = (const struct snapshot *)snapshot_segments[i];
+        for (j = 0; j < SNAPSHOT_SLOTS; j++, snap++)
+        {
+            if (snap->magic != SNAPSHOT_MAGIC || snap->version != SNAPSHOT_VERSION ||
+                snap->checksum != snapshot_checksum(snap))
+            {
+                continue;
+            }
+            if (best == 0 || (int)(snap->sequence - best->sequence) > 0)
+            {
+                best = snap;
+            }
+        }
+    }
+    return best;
+}
+
+/* Index of the snapshot segment holding snap
+ */
+int snapshot_segment(const struct snapshot *snap)
+{
+    return (const unsigned char *)snap >= snapshot_segments[1];
+}
+
+/* Returns the first slot of a snapshot segment that was not
+ * written since its last erase, or 0 if the segment is full
+ */
+struct snapshot *free_snapshot_slot(unsigned char *segment)
+{
+    struct snapshot *slot = (struct snapshot *)segment;
+    unsigned int i;
+    for (i = 0; i < SNAPSHOT_SLOTS; i++, slot++)
+    {
+        if (slot->magic == (unsigned int)~0)
+        {
+            return slot;
+        }
+    }
+    return 0;
+}
+
+/* Packs the whole game state into a snapshot and writes it to the
+ * next free slot, in the segment of the newest snapshot or else in
+ * the other one. Older snapshots are never overwritten, so a
+ * brown-out during the write still leaves the previous one. Only
+ * programs the slot: erase_old_snapshots makes room at the points
+ * where the game waits anyway, a segment is erased here only when
+ * both filled up since then (about 25ms).
+ */
+void save_snapshot(struct paddle *player, struct paddle *computer, struct ball *ball, int player_select, int paused)
+{
+    const struct snapshot *newest = find_snapshot();
+    int current = newest ? snapshot_segment(newest) : 0;
+    struct snapshot snap;
+    struct snapshot *slot;
+    unsigned int sr;
+
+    snap.magic = SNAPSHOT_MAGIC;
+    snap.sequence = newest ? newest->sequence + 1 : 0;
+    snap.version = SNAPSHOT_VERSION;
+    snap.player_select = player_select;
+    snap.ai_select = ai_select;
+    snap.paused = paused;
+    snap.player_y = player->y;
+    snap.computer_y = computer->y;
+    snap.player_score = player->score;
+    snap.computer_score = computer->score;
+    snap.ball_x = ball->x;
+    snap.ball_y = ball->y;
+    snap.ball_x_vel = ball->x_vel;
+    snap.ball_y_vel = ball->y_vel;
+    snap.speed_flag = speed_flag;
+    snap.game_point_flag = game_point_flag;
+    snap.count = count;
+    snap.seed = game_seed;
+    snap.ai_delay[0] = player->ai.delay_counter;
+    snap.ai_delay[1] = computer->ai.delay_counter;
+    snap.ai_target_y[0] = player->ai.target_y;
+    snap.ai_target_y[1] = computer->ai.target_y;
+    snap.ai_intercept_y[0] = player->ai.intercept_y;
+    snap.ai_intercept_y[1] = computer->ai.intercept_y;
+    snap.ai_current = (player->ai.epoch == ball_epoch) + ((computer->ai.epoch == ball_epoch) << 1);
+    snap.checksum = 0;
+    snap.checksum = snapshot_checksum(&snap);
+
+    sr = __get_SR_register();
+    __disable_interrupt();
+    slot = free_snapshot_slot(snapshot_segments[current]);
+    if (slot == 0)
+    {
+        slot = free_snapshot_slot(snapshot_segments[!current]);
+    }
+    if (slot == 0)
+    {
+        flash_erase_segment(snapshot_segments[!current]);
+        slot = (struct snapshot *)snapshot_segments[!current];
+    }
+    flash_write((unsigned char *)slot, (const unsigned char *)&snap, sizeof(snap));
+    if (sr & GIE)
+    {
+        __enable_interrupt();
+    }
+}
+
+/* Erases the snapshot segments that were written to but don't
+ * hold the newest snapshot, so the saves that follow find free
+ * slots. Called where the game waits anyway (pause, game over)
+ * to keep the 25ms erases out of the frames.
+ */
+void erase_old_snapshots()
+{
+    const struct snapshot *newest = find_snapshot();
+    unsigned int sr = __get_SR_register();
+    int i;
+
+    __disable_interrupt();
+    for (i = 0; i < 2; i++)
+    {
+        if ((newest == 0 || i != snapshot_segment(newest)) &&
+            ((const struct snapshot *)snapshot_segments[i])->magic != (unsigned int)~0)
+        {
+            flash_erase_segment(snapshot_segments[i]);
+        }
+    }
+    if (sr & GIE)
+    {
+        __enable_interrupt();
+    }
+}
+
+/* Marks every snapshot as used up, so the next boot starts
+ * with the intro again
+ */
+void clear_snapshot()
+{
+    const struct snapshot *snap;
+    unsigned char zero = 0;
+    unsigned int sr = __get_SR_register();
+    unsigned int i, j;
+
+    __disable_interrupt();
+    for (i = 0; i < 2; i++)
+    {
+        snap = (const struct snapshot *)snapshot_segments[i];
+        for (j = 0; j < SNAPSHOT_SLOTS; j++, snap++)
+        {
+            // Programming the version to 0 needs no erase
+            if (snap->magic == SNAPSHOT_MAGIC && snap->version != 0)
+            {
+                flash_write((unsigned char *)&snap->version, &zero, sizeof(zero));
+            }
+        }
+    }
+    if (sr & GIE)
+    {
+        __enable_interrupt();
+    }
+}
+
+/* Restores the game from the newest snapshot, if there is one.
+ * Returns 1 if a game was restored, 0 otherwise.
+ */
+int load_snapshot(struct paddle *player, struct paddle *computer, struct ball *ball, int *player_select, int *paused)
+{
+    const struct snapshot *snap = find_snapshot();
+    if (snap == 0)
+    {
+        return 0;
+    }
+
+    set_up_game(player, computer, ball);
+    *player_select = snap->player_select;
+    *paused = snap->paused;
+    ai_select = snap->ai_select;
+    player->y = snap->player_y;
+    computer->y = snap->computer_y;
+    player->score = snap->player_score;
+    computer->score = snap->computer_score;
+    ball->x = snap->ball_x;
+    ball->y = snap->ball_y;
+    ball->x_vel = snap->ball_x_vel;
+    ball->y_vel = snap->ball_y_vel;
+    speed_flag = snap->speed_flag;
+    game_point_flag = snap->game_point_flag;
+    count = snap->count;
+    game_seed = snap->seed;
+    player->ai.delay_counter = snap->ai_delay[0];
+    computer->ai.delay_counter = snap->ai_delay[1];
+    player->ai.target_y = snap->ai_target_y[0];
+    computer->ai.target_y = snap->ai_target_y[1];
+    player->ai.intercept_y = snap->ai_intercept_y[0];
+    computer->ai.intercept_y = snap->ai_intercept_y[1];
+    player->ai.epoch = (snap->ai_current & 1) ? ball_epoch : -1;
+    computer->ai.epoch = (snap->ai_current & 2) ? ball_epoch : -1;
+    return 1;
+}
+
+/* Checksum of a stats record, which ends with its checksum byte
+ */
+unsigned char stats_checksum(const unsigned char *bytes, int size)
+{
+    unsigned char sum = 0x5A;
+    while (--size > 0)
+    {
+        sum += *bytes++;
+    }
+    return sum;
+}
+
+/* Adds one logged game to the totals
+ */
+void add_game(struct stats *totals, const struct stats_game *game)
+{
+    int computer = game->sides & 3;
+    int player = (game->sides >> 4) - 1; // -1 for a person
+
+    totals->played[computer]++;
+    if (player >= 0)
+    {
+        totals->played[player & 3]++;
+    }
+    if (game->computer_won)
+    {
+        totals->won[computer]++;
+    }
+    else if (player >= 0)
+    {
+        totals->won[player & 3]++;
+    }
+    totals->play_seconds += game->seconds;
+    if (game->longest_rally > totals->longest_rally)
+    {
+        totals->longest_rally = game->longest_rally;
+    }
+    if (game->max_speed > totals->max_speed)
+    {
+        totals->max_speed = game->max_speed;
+    }
+}
+
+/* Loads the newest totals in info flash into stats and adds the
+ * games logged after them
+ */
+void load_stats()
+{
+    const struct stats *totals;
+    const struct stats_game *game;
+    struct stats none = {0};
+    int i;
+
+    stats_segment = 0;
+    stats_games = 0;
+    for (i = 0; i < 2; i++)
+    {
+        totals = (const struct stats *)stats_segments[i];
+        if (totals->magic != STATS_MAGIC ||
+            totals->checksum != stats_checksum((const unsigned char *)totals, sizeof(struct stats)))
+        {
+            continue;
+        }
+        if (stats_segment == 0 || (int)(totals->sequence - ((const struct stats *)stats_segment)->sequence) > 0)
+        {
+            stats_segment = stats_segments[i];
+        }
+    }
+    if (stats_segment == 0)
+    {
+        stats = none;
+        return;
+    }
+
+    stats = *(const struct stats *)stats_segment;
+    game = (const struct stats_game *)(stats_segment + sizeof(struct stats));
+    while (stats_games < STATS_GAMES && game->sides != 0xFF) // 0xFF: not written yet
+    {
+        // A game cut short by a brown-out keeps its slot but isn't counted
+        if (game->checksum == stats_checksum((const unsigned char *)game, sizeof(struct stats_game)))
+        {
+            add_game(&stats, game);
+        }
+        game++;
+        stats_games++;
+    }
+}
+
+/* Segment A has a lock of its own, which every write of LOCKA flips
+ */
+void flash_lock_a(int lock)
+{
+    if (!(FCTL3 & LOCKA) == !lock)
+    {
+        return;
+    }
+    FCTL3 = FWKEY + LOCK + LOCKA;
+}
+
+/* Puts the game that just ended in the stats log. It is appended
+ * after the totals in the newest stats segment (8 bytes, no erase);
+ * every STATS_GAMES games that segment is full and the other one is
+ * erased and started with the new totals, so a brown-out during the
+ * erase still leaves the older totals. Called at game over only, as
+ * the erase takes about 25ms.
+ */
+void record_match(struct paddle *player, struct paddle *computer, int player_select)
+{
+    struct stats_game game;
+    unsigned char *segment;
+    unsigned int sr;
+
+    game.sides = ai_select + ((player_select + 1) << 4);
+    game.computer_won = computer->score > player->score;
+    game.longest_rally = match_longest_rally;
+    game.seconds = clock_seconds - match_start;
+    game.max_speed = match_max_speed;
+    game.checksum = stats_checksum((const unsigned char *)&game, sizeof(game));
+    add_game(&stats, &game);
+
+    sr = __get_SR_register();
+    __disable_interrupt();
+    flash_lock_a(0);
+    if (stats_segment != 0 && stats_games < STATS_GAMES)
+    {
+        flash_write(stats_segment + sizeof(struct stats) + stats_games * sizeof(struct stats_game),
+                    (const unsigned char *)&game, sizeof(game));
+        stats_games++;
+    }
+    else
+    {
+        segment = stats_segments[stats_segment == stats_segments[0]];
+        stats.magic = STATS_MAGIC;
+        stats.sequence++;
+        stats.checksum = stats_checksum((const unsigned char *)&stats, sizeof(stats));
+        flash_erase_segment(segment);
+        flash_write(segment, (const unsigned char *)&stats, sizeof(stats));
+        stats_segment = segment;
+        stats_games = 0;
+    }
+    flash_lock_a(1);
+    if (sr & GIE)
+    {
+        __enable_interrupt();
+    }
+}
+
+/* Draws a restored game in one pass: one screen clear, then
+ * the ball, game point markers and scores. The paddles start
+ * out hidden in the game loop, its first show_paddle draws them.
+ */
+void redraw_field(struct paddle *player, struct paddle *computer, struct ball *ball)
+{
+    write_zeros();
+    draw_ball(ball->x, ball->y);
+    if (player->score == 4)
+    {
+        draw_string(18, 0, font_8x8, "G");
+    }
+    if (computer->score == 4)
+    {
+        draw_string(77, 0, font_8x8, "G");
+    }
+    display_score(player->score, 6, 4);
+    display_score(computer->score, 2, 0);
+}
+
+/* Draws the title screen on a clear panel
+ */
+void draw_title()
+{
+#ifdef FAST_BOOT
+    // The title goes out in one pass
+    draw_image(title_image);
+#else
+    // Also in tools/title_image.c
+    char str[] = "PONG";
+    draw_string(35, 1, font_8x8, str);
+    char firstto5[] = "FIRST TO 5";
+    char wins[] = "WINS!";
+    draw_string(10, 3, font_8x8, firstto5);
+    draw_string(35, 4, font_8x8, wins);
+    draw_string(3, 5, font_8x8, "Press: STATS");
+    draw_string(20, 6, font_8x8, "Twist to");
+    draw_string(32, 7, font_8x8, "START");
+#endif
+}
+
+/* wait_for_player_or_link on the title screen: the stats page
+ * is shown when asked for, until the knob is turned
+ */
+int wait_on_title()
+{
+    int link_side;
+
+    while ((link_side = wait_for_player_or_link()) == SHOW_STATS)
+    {
+        show_stats();
+        __delay_cycles(100000);
+        wait_for_player_input();
+        write_zeros();
+        draw_title();
+    }
+    return link_side;
+}
+
+void main(void)
+{
+
+    // Stop the watchdog timer so it doesn't reset our chip
+    WDTCTL = WDTPW + WDTHOLD;
+#if defined(FAST_BOOT) || defined(PROFILE)
+    TA1CTL = TASSEL_2 + MC_2 + ID_3 + TACLR; // SMCLK / 8, times the boot
+#endif
+#ifdef SPI_TRACE
+    srand(SPI_TRACE_SEED);
+#else
+    srand(time(0));
+#endif
+    game_seed = rand() | 1;
+#ifdef FAST_BOOT
+    // Fast boot: the intro starts at once and plays on the audio MCU
+    // while the rest of the setup fills the panel's start up wait
+    init_SPI();
+    init_audio_link();
+    if (!find_snapshot())
+    {
+        play_music(2);
+    }
+    init_MPD();
+    P2DIR &= ~BIT1; // Set P2.1 as input
+    P2REN |= BIT1;  // Enable pull-up/down resistor for P2.1
+    P2OUT |= BIT1;  // Configure pull-up resistor for P2.1
+    init_ADC();
+    init_link();
+    while (TA1R < BOOT_SETTLE_TICKS)
+        ;
+    init_lcd();
+#else
+    init_MPD();
+    init_SPI();
+    init_audio_link();
+    P2DIR &= ~BIT1; // Set P2.1 as input
+    P2REN |= BIT1;  // Enable pull-up/down resistor for P2.1
+    P2OUT |= BIT1;  // Configure pull-up resistor for P2.1
+    __delay_cycles(5500); // Pause so everything has time to start up properly.
+    init_lcd();
+    init_ADC();
+    init_link();
+    load_stats();
+#endif
+
+#ifdef FRAME_BENCH
+    run_frame_bench();
+#endif
+
+    // Debug button held at power-on: time the display primitives
+    if (!(P2IN & BIT1))
+    {
+        run_render_benchmark();
+    }
+
+    struct paddle player;
+    struct paddle computer;
+    struct ball ball;
+    int player_select = -1;
+    int isPaused = 0;
+    int resume_paused = 0;
+
+    // A game was going on before the power went: skip the intro and menus
+    if (load_snapshot(&player, &computer, &ball, &player_select, &resume_paused))
+    {
+        redraw_field(&player, &computer, &ball);
+    }
+    else
+    {
+#ifndef FAST_BOOT
+        start_animation(); // with FAST_BOOT the intro is already playing
+#endif
+        set_up_game(&player, &computer, &ball);
+        draw_title();
+#ifdef PROFILE
+        // Debug view: power-up to here, in cycles
+        char boot[11];
+        boot_cycles = TA1R * 8UL;
+        draw_string(0, 0, font_8x8, "Boot");
+        number_to_string(boot_cycles, boot);
+        draw_string(40, 0, font_8x8, boot);
+#endif
+        PANEL_DUMP("title");
+
+        int link_side = wait_on_title();
+        start_animation();
+
+        // Another console answered: play linked games until one is started alone
+        while (link_side >= 0)
+        {
+            run_link_game(link_side);
+            link_side = wait_on_title();
+            start_animation();
+        }
+        game_seed = rand() | 1;
+
+        if (!(P2IN & BIT1))
+        {
+            player_select = get_player();
+            start_animation();
+
+            // Still holding the debug button: AI vs AI tournament
+            if (!(P2IN & BIT1))
+            {
+                run_turbo_tournament();
+                set_up_game(&player, &computer, &ball);
+            }
+        }
+
+        ai_select = get_ai();
+        start_animation();
+
+        // Holding the debug button after choosing a rival: multi-ball game
+        if (!(P2IN & BIT1))
+        {
+            while (!(P2IN & BIT1))
+                ;
+            run_multi_ball(&player, &computer, player_select);
+            set_up_game(&player, &computer, &ball); // then a regular game against the same rival
+        }
+        save_snapshot(&player, &computer, &ball, player_select, 0);
+    }
+#ifdef FAST_BOOT
+    load_stats(); // first needed at game over, not worth holding up the title
+#endif
+    int saved_points = player.score + computer.score;
+    int player_shown = PADDLE_HIDDEN, computer_shown = PADDLE_HIDDEN; // paddle y's on the panel
+#if defined(PROFILE) || defined(TELEMETRY)
+    init_cycle_timer();
+#endif
+#ifdef SPI_TRACE
+    unsigned int rally_frames = 0; // frames into the game, the "rally" image is taken at 300
+#endif
+#ifdef TELEMETRY
+    unsigned int frame_start = TA1R;
+    int computer_old_y = computer.y;
+#endif
+
+    while (1)
+    {
+
+        PROFILE_BEGIN(PHASE_FRAME);
+        count++;
+        set_ball_speed(&ball);
+        PROFILE_BEGIN(PHASE_ADC);
+        char adc_position = get_adc_position();
+        PROFILE_END(PHASE_ADC);
+        PROFILE_BEGIN(PHASE_CLEAR);
+        clear_ball(ball.x, ball.y);
+        hide_paddle_under_ball(ball.x, &player, &player_shown);
+        hide_paddle_under_ball(ball.x, &computer, &computer_shown);
+        PROFILE_END(PHASE_CLEAR);
+        if (isPaused == 0)
+        {
+            if (resume_paused || !(P2IN & BIT1))
+            {
+                resume_paused = 0;
+                isPaused = 1;
+                PROFILE_SKIP(PHASE_FRAME);
+                x_left = 10;
+                x_right = 85;
+                hide_paddle(&player, &player_shown);
+                hide_paddle(&computer, &computer_shown);
+                stop_music();
+                pause_animation();
+                save_snapshot(&player, &computer, &ball, player_select, 1);
+                erase_old_snapshots();
+#ifdef SPI_TRACE
+                spi_trace_report();
+                draw_string(20, 5, font_8x8, "Press to");
+                draw_string(32, 6, font_8x8, "RESUME");
+                panel_dump("pause");
+#endif
+
+                while (isPaused)
+                {
+                    draw_string(20, 5, font_8x8, "Press to");
+                    draw_string(32, 6, font_8x8, "RESUME");
+#ifdef PROFILE
+                    // Debug view: slowest phase and its worst time
+                    char worst[13];
+                    int phase = profile_worst_phase();
+                    draw_string(0, 7, font_8x8, phase_names[phase]);
+                    number_to_string(profile[phase].max, worst);
+                    draw_string(62, 7, font_8x8, worst);
+#endif
+                    __delay_cycles(100000);
+                    if (!(P2IN & BIT1))
+                    {
+                        clear_animation();
+                        draw_string(20, 5, font_8x8, "        ");
+                        draw_string(32, 6, font_8x8, "      ");
+#ifdef PROFILE
+                        draw_string(0, 7, font_8x8, "             ");
+#endif
+                        isPaused = 0;
+                        break;
+                    }
+                }
+            }
+            PROFILE_BEGIN(PHASE_AI);
+            if (player_select == -1)
+            {
+                move_player(&player, adc_position);
+            }
+            else
+            {
+                ai_functions[player_select](&player, &ball);
+            }
+            ai_functions[ai_select](&computer, &ball);
+            PROFILE_END(PHASE_AI);
+            PROFILE_BEGIN(PHASE_PHYSICS);
+            move_ball(&ball);
+            check_collision(&ball, &player, &computer);
+            update_score(&player, &computer, &ball);
+            if (player.score == 5 || computer.score == 5)
+            {
+                clear_snapshot();
+                erase_old_snapshots();
+                record_match(&player, &computer, player_select);
+                player_shown = PADDLE_HIDDEN; // the game over screens clear the panel
+                computer_shown = PADDLE_HIDDEN;
+                PROFILE_SKIP(PHASE_PHYSICS); // check_game_over waits for the knob
+                PROFILE_SKIP(PHASE_FRAME);
+            }
+            check_game_over(&player, &computer, &ball);
+            PROFILE_END(PHASE_PHYSICS);
+
+            // Keep the snapshot in flash up to date with every point
+            if (player.score + computer.score != saved_points)
+            {
+                saved_points = player.score + computer.score;
+                save_snapshot(&player, &computer, &ball, player_select, 0);
+            }
+        }
+        PROFILE_BEGIN(PHASE_DRAW);
+        show_paddle(&player, &player_shown);
+        show_paddle(&computer, &computer_shown);
+        draw_ball(ball.x, ball.y);
+        PROFILE_END(PHASE_DRAW);
+        PROFILE_END(PHASE_FRAME);
+#ifdef SPI_TRACE
+        spi_trace_frame();
+        if (++rally_frames == 300)
+        {
+            panel_dump("rally");
+        }
+#endif
+#ifdef TELEMETRY
+        send_telemetry(&player, &computer, &ball, computer_old_y, TA1R - frame_start);
+        frame_start = TA1R;
+        computer_old_y = computer.y;
+#endif
+    }
+}
+
+/* Latches the digits of the 7-segment display that should change:
+ * new scores, the dark part of every brightness period and blinking
+ */
+void __attribute__((interrupt(TIMER0_A0_VECTOR))) TIMER0_A0_ISR(void)
+{
+    unsigned char i, code;
+
+    display_tick++;
+    if ((display_tick & (DISPLAY_TICK_HZ - 1)) == 0)
+    {
+        clock_seconds++;
+    }
+    for (i = 0; i < DISPLAY_DIGITS; i++)
+    {
+        code = display_digits[i];
+        if ((display_tick & (DISPLAY_LEVELS - 1)) >= display_brightness ||
+            ((code & DIGIT_BLINK) && (display_tick & DISPLAY_BLINK_TICK)))
+        {
+            code = DIGIT_BLANK;
+        }
+        code &= 0x0F;
+        if (code != display_latched[i])
+        {
+            P4OUT = code;
+            P8OUT = i << 1;
+            P7OUT = 0b00000000;
+            P7OUT = 0b00000001;
+            display_latched[i] = code;
+        }
+    }
+}
+
+// Queues the bytes received on the console link
+void __attribute__((interrupt(USCI_A1_VECTOR))) USCI_A1_ISR(void)
+{
+    if (UCA1IFG & UCRXIFG)
+    {
+        link_rx[link_rx_head & (LINK_RX_SIZE - 1)] = UCA1RXBUF;
+        link_rx_head++;
     }
 }
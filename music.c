@@ -1,172 +1,612 @@
 #include <msp430.h>
+#include <audio_link.h>
+#include <songs.h>
+#include <clips.h>
+
+// A sample costs SYNTH_ISR_CYCLES + SYNTH_VOICES * SYNTH_VOICE_CYCLES,
+// msp430_sim's counts for TIMER0_A0_ISR and mix() in tools/cycles.txt:
+// 109 of the SYNTH_PERIOD of 1000 cycles for 3 voices. SYNTH_BUDGET
+// would take (500 - 46) / 21 = 21 voices, so the PWM range is what
+// holds it at 3: SYNTH_VOICES * 255 has to stay below SYNTH_PERIOD
+// (a clip on top can clip). Build with SYNTH_PROFILE to measure both
+// counts on the board.
+#define SYNTH_VOICES 3
+#define SYNTH_ISR_CYCLES 46   // interrupt entry to reti, mix() excepted
+#define SYNTH_VOICE_CYCLES 21 // a pass of mix()'s loop
+#define SYNTH_BUDGET (SYNTH_PERIOD / 2) // of a sample, the rest is for the link and the notes
+
+#if SYNTH_ISR_CYCLES + SYNTH_VOICES * SYNTH_VOICE_CYCLES > SYNTH_BUDGET
+#error "the voices take more than SYNTH_BUDGET"
+#endif
+#if SYNTH_VOICES * 255 >= SYNTH_PERIOD
+#error "the voices overflow the PWM period"
+#endif
+
+// 256 entry wave shapes, filled in by init_synth()
+#define WAVE_SQUARE 0
+#define WAVE_PULSE 1
+#define WAVE_TRIANGLE 2
+#define WAVES 3
+#define WAVE_SIZE 256
+
+unsigned char waves[WAVES][WAVE_SIZE];
+
+// Recorded sounds (clips.h), streamed by DMA 0 straight into the PWM
+// duty, or into clip_sample for the sample interrupt to mix in while a
+// voice plays
+#define CLIP_PERIOD (AUDIO_MCLK_HZ / CLIP_RATE) // SMCLK counts between samples
+#define CLIP_MERGE (CLIP_RATE / 50)              // samples (20ms) a clip counts as just started
+
+struct clip
+{
+    const unsigned char *samples;
+    unsigned int length;
+};
+
+const struct clip hit_sound = {hit_clip, HIT_CLIP_LENGTH};
+const struct clip score_sound = {score_clip, SCORE_CLIP_LENGTH};
+
+struct song
+{
+    const struct note *notes; // see audio_link.h
+    int priority;             // a song cuts off any song of lower priority on its voice
+    unsigned char stale;      // pending songs (bit per id) dropped when this one starts
+    int voice;
+    int wave;
+    const struct clip *clip; // played instead of the notes when there is one
+};
+
+const struct song songs[4] = {
+    {score_notes, 2, 0x02, 1, WAVE_TRIANGLE, &score_sound}, // SONG_SCORE
+    {hit_notes, 1, 0x00, 2, WAVE_PULSE, &hit_sound},        // SONG_HIT
+    {intro_notes, 0, 0x00, 0, WAVE_SQUARE, 0},              // SONG_INTRO
+    {game_over_notes, 3, 0x03, 0, WAVE_SQUARE, 0},          // SONG_GAME_OVER
+};
+
+// Filled in by AUDIO_UPLOAD, plays at the intro's priority
+struct note uploaded_notes[AUDIO_UPLOAD_NOTES + 1];
+const struct song uploaded_song = {uploaded_notes, 0, 0x00, 0, WAVE_SQUARE, 0};
+
+// Indexed by song id, see audio_link.h
+const struct song *const song_list[SONGS] = {
+    &songs[0], &songs[1], &songs[2], &songs[3], &uploaded_song};
+
+// Songs (bit per id) each voice plays, and the ones that are clips
+const unsigned char voice_songs[SYNTH_VOICES] = {0x1C, 0x01, 0x02};
+const unsigned char clip_songs = 0x03;
+
+// Highest priority id in a pending mask: game over, score, hit, intro, uploaded
+const signed char next_song[32] = {
+    -1, 0, 1, 0, 2, 0, 1, 0, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 0, 1, 0, 2, 0, 1, 0, 3, 3, 3, 3, 3, 3, 3, 3};
+
+// Scales are in 256ths, worked out when a command arrives so that
+// playing a note only multiplies
+#define SCALE_ONE 256
+
+struct voice
+{
+    // Mixed by TIMER0_A0_ISR every sample
+    unsigned int phase;
+    unsigned int step; // 0 holds the voice still
+    const unsigned char *wave;
+    // Moved on by Timer A1 at the end of every note
+    const struct song *song; // 0 when quiet
+    const struct note *note;
+    int repeats;        // left at the NOTE_REPEAT being played
+    unsigned int scale; // steps, from AUDIO_PLAY_EFFECT
+};
+
+struct voice voices[SYNTH_VOICES];
+
+volatile unsigned int clip_sample = 0;             // the clip's sample now, while the voices mix it in
+volatile unsigned int *clip_output = &clip_sample; // where DMA 0 writes it: clip_sample or TA0CCR1
+const struct song *clip_song = 0;      // whose clip is playing, 0 if none
+
+// Voice v's note ends when Timer A1 reaches note_end[v]
+volatile unsigned int *const note_end[SYNTH_VOICES] = {&TA1CCR0, &TA1CCR1, &TA1CCR2};
+volatile unsigned int *const note_control[SYNTH_VOICES] = {&TA1CCTL0, &TA1CCTL1, &TA1CCTL2};
+
+unsigned int tempo_scale = SCALE_ONE; // note lengths, from AUDIO_SET_TEMPO
+unsigned char songs_pending = 0;      // bit per id, waiting for the song playing on its voice to end
+unsigned int pending_scale[SONGS];
+
+// Command frame being received, see USCI_B1_ISR
+unsigned char command[AUDIO_FRAME_SIZE];
+int command_bytes = 0;
+unsigned char command_sum = 0;
+int synth_ready = 0; // before, the first complete frame is held for main to run
+unsigned char held_command[AUDIO_FRAME_SIZE];
+int command_held = 0;
 
-#define NOTE_B0  31
-#define NOTE_C1  33
-#define NOTE_CS1 35
-#define NOTE_D1  37
-#define NOTE_DS1 39
-#define NOTE_E1  41
-#define NOTE_F1  44
-#define NOTE_FS1 46
-#define NOTE_G1  49
-#define NOTE_GS1 52
-#define NOTE_A1  55
-#define NOTE_AS1 58
-#define NOTE_B1  62
-#define NOTE_C2  65
-#define NOTE_CS2 69
-#define NOTE_D2  73
-#define NOTE_DS2 78
-#define NOTE_E2  82
-#define NOTE_F2  87
-#define NOTE_FS2 93
-#define NOTE_G2  98
-#define NOTE_GS2 104
-#define NOTE_A2  110
-#define NOTE_AS2 117
-#define NOTE_B2  123
-#define NOTE_C3  131
-#define NOTE_CS3 139
-#define NOTE_D3  147
-#define NOTE_DS3 156
-#define NOTE_E3  165
-#define NOTE_F3  175
-#define NOTE_FS3 185
-#define NOTE_G3  196
-#define NOTE_GS3 208
-#define NOTE_A3  220
-#define NOTE_AS3 233
-#define NOTE_B3  247
-#define NOTE_C4  262
-#define NOTE_CS4 277
-#define NOTE_D4  294
-#define NOTE_DS4 311
-#define NOTE_E4  330
-#define NOTE_F4  349
-#define NOTE_FS4 370
-#define NOTE_G4  392
-#define NOTE_GS4 415
-#define NOTE_A4  440
-#define NOTE_AS4 466
-#define NOTE_B4  494
-#define NOTE_C5  523
-#define NOTE_CS5 554
-#define NOTE_D5  587
-#define NOTE_DS5 622
-#define NOTE_E5  659
-#define NOTE_F5  698
-#define NOTE_FS5 740
-#define NOTE_G5  784
-#define NOTE_GS5 831
-#define NOTE_A5  880
-#define NOTE_AS5 932
-#define NOTE_B5  988
-#define NOTE_C6  1047
-#define NOTE_CS6 1109
-#define NOTE_D6  1175
-#define NOTE_DS6 1245
-#define NOTE_E6  1319
-#define NOTE_F6  1397
-#define NOTE_FS6 1480
-#define NOTE_G6  1568
-#define NOTE_GS6 1661
-#define NOTE_A6  1760
-#define NOTE_AS6 1865
-#define NOTE_B6  1976
-#define NOTE_C7  2093
-#define NOTE_CS7 2217
-#define NOTE_D7  2349
-#define NOTE_DS7 2489
-#define NOTE_E7  2637
-#define NOTE_F7  2794
-#define NOTE_FS7 2960
-#define NOTE_G7  3136
-#define NOTE_GS7 3322
-#define NOTE_A7  3520
-#define NOTE_AS7 3729
-#define NOTE_B7  3951
-#define NOTE_C8  4186
-#define NOTE_CS8 4435
-#define NOTE_D8  4699
-#define NOTE_DS8 4978
 /**
  * main.c
  */
-void init_PWM()
+
+/* Raises the core voltage one level at a time up to level,
+ * MCLK can then run up to 8 (0), 12 (1), 20 (2) or 25MHz (3)
+ */
+void set_core_level(unsigned int level)
 {
+    PMMCTL0_H = PMMPW_H;
+    SVSMHCTL = SVSHE + SVSHRVL0 * level + SVMHE + SVSMHRRL0 * level;
+    SVSMLCTL = SVSLE + SVMLE + SVSMLRRL0 * level;
+    while ((PMMIFG & SVSMLDLYIFG) == 0)
+        ;
+    PMMIFG &= ~(SVMLVLRIFG + SVMLIFG);
+    PMMCTL0_L = PMMCOREV0 * level;
+    if (PMMIFG & SVMLIFG)
+    {
+        while ((PMMIFG & SVMLVLRIFG) == 0)
+            ;
+    }
+    SVSMLCTL = SVSLE + SVSLRVL0 * level + SVMLE + SVSMLRRL0 * level;
+    PMMCTL0_H = 0x00;
+}
+
+/* Runs MCLK and SMCLK at AUDIO_MCLK_HZ from the DCO, locked to
+ * REFO by the FLL, which also drives ACLK (32768Hz)
+ */
+void init_clock()
+{
+    set_core_level(1);
+    set_core_level(2);
+
+    UCSCTL3 = SELREF__REFOCLK;
+    UCSCTL4 = SELA__REFOCLK + SELS__DCOCLKDIV + SELM__DCOCLKDIV;
+    __bis_SR_register(SCG0); // FLL off while it is set up
+    UCSCTL0 = 0;
+    UCSCTL1 = DCORSEL_6;
+    UCSCTL2 = FLLD_1 + 487; // (487 + 1) x 32768Hz
+    __bic_SR_register(SCG0);
+    __delay_cycles(500000); // 32 x 32 x 16MHz / 32768Hz for the FLL to settle
+
+    do
+    {
+        UCSCTL7 &= ~(XT2OFFG + XT1LFOFFG + DCOFFG);
+        SFRIFG1 &= ~OFIFG;
+    } while (SFRIFG1 & OFIFG);
+}
+
+/* Starts the PWM on P1.2 at SYNTH_RATE, its duty set by every
+ * sample (TIMER0_A0_ISR), and Timer A1 counting note lengths
+ */
+void init_synth()
+{
+    int i, v;
+
+    for (i = 0; i < WAVE_SIZE; i++)
+    {
+        waves[WAVE_SQUARE][i] = i < WAVE_SIZE / 2 ? 255 : 0;
+        waves[WAVE_PULSE][i] = i < WAVE_SIZE / 4 ? 255 : 0;
+        waves[WAVE_TRIANGLE][i] = i < WAVE_SIZE / 2 ? 2 * i : 511 - 2 * i;
+    }
+    for (v = 0; v < SYNTH_VOICES; v++)
+    {
+        voices[v].wave = waves[WAVE_SQUARE];
+    }
+
     P1DIR |= BIT2; // Output on Pin 1.2
     P1SEL |= BIT2; // Pin 1.2 selected as PWM
-    // microseconds
-    TA0CCTL1 = OUTMOD_7; // TA0CCR1 reset/set-high voltage
-    // below count, low voltage when past
-    TA0CTL = TASSEL_2 + MC_1 + TAIE + ID_0;
-    // Timer A control set to SMCLK, 1MHz
-    // and count up mode MC_1
+    TA0CCR0 = SYNTH_PERIOD - 1;
+    TA0CCR1 = 0;
+    TA0CCTL1 = OUTMOD_7;                 // high below TA0CCR1, low past it
+    TA0CTL = TASSEL_2 + MC_1 + TACLR;    // SMCLK, up mode
+    TA1CTL = TASSEL_1 + MC_2 + ID_1 + TACLR; // ACLK / 2, continuous mode
+    DMACTL0 = DMA0TSEL_5;                    // TA2CCR0, see play_clip()
+}
+
+/* Initializes USCI B1 as the SPI slave of the command link
+ * (see audio_link.h)
+ * SIMO = P4.1
+ * CLK = P4.3
+ */
+void init_command_link()
+{
+    P4SEL |= BIT1 + BIT3;
+    UCB1CTL1 |= UCSWRST;
+    UCB1CTL0 = UCSYNC + UCMSB + UCCKPH; // 3-pin SPI slave
+    UCB1CTL1 &= ~UCSWRST;
+    UCB1IE |= UCRXIE;
+}
+
+/* Returns the sum of the next sample of the first count voices,
+ * 0..count * 255
+ */
+unsigned int mix(int count)
+{
+    struct voice *voice = voices;
+    unsigned int level = 0;
+
+    for (; count > 0; count--, voice++)
+    {
+        voice->phase += voice->step;
+        level += voice->wave[(unsigned char)(voice->phase >> 8)];
+    }
+    return level;
 }
-void reset_msp430()
+
+#ifdef SYNTH_PROFILE
+/* Cycle budget of the synthesizer, in MCLK cycles counted by the PWM
+ * timer (SMCLK = MCLK), to hold against SYNTH_ISR_CYCLES and
+ * SYNTH_VOICE_CYCLES. Read it with the debugger:
+ *   synth_cycles[n]     a call to mix(n), n = 0..SYNTH_VOICES
+ *   synth_voice_cycles  what every voice adds to a sample
+ *   synth_voices_fit    voices mix() can take within SYNTH_BUDGET
+ *   synth_isr_max       latest end of TIMER0_A0_ISR after its sample
+ *                       tick, entry and other interrupts included
+ */
+unsigned int synth_cycles[SYNTH_VOICES + 1];
+unsigned int synth_voice_cycles;
+unsigned int synth_voices_fit;
+unsigned int synth_isr_max = 0;
+
+#define SYNTH_PROFILE_END()          \
+    if (TA0R > synth_isr_max)        \
+    {                                \
+        synth_isr_max = TA0R;        \
+    }
+
+void synth_measure()
 {
-    WDTCTL = 0x6900 | WDTPW | WDTCNTCL;                   // Write watchdog password and clear the timer
-    WDTCTL = 0x6900 | WDTPW | WDTCNTCL | WDTIS0 | WDTIS1; // W}
+    unsigned int start;
+    int n;
+
+    for (n = 0; n <= SYNTH_VOICES; n++)
+    {
+        start = TA0R;
+        mix(n);
+        synth_cycles[n] = (TA0R + SYNTH_PERIOD - start) % SYNTH_PERIOD;
+    }
+    synth_voice_cycles = (synth_cycles[SYNTH_VOICES] - synth_cycles[0]) / SYNTH_VOICES;
+    synth_voices_fit = (SYNTH_BUDGET - synth_cycles[0]) / synth_voice_cycles;
 }
-void play_music(int sel)
+#else
+#define SYNTH_PROFILE_END()
+#endif
+
+/* Returns value * by / SCALE_ONE, held to 16 bits
+ */
+unsigned int scale(unsigned int value, unsigned int by)
 {
-    if (sel == 3) // play game over music
+    unsigned long scaled = ((unsigned long)value * by) >> 8;
+    return scaled > 0xFFFF ? 0xFFFF : scaled;
+}
+
+/* Timer A1 counts from ACLK, so it is read until two reads agree
+ */
+unsigned int note_clock()
+{
+    unsigned int now;
+
+    do
     {
-        int music[] = {NOTE_G4, NOTE_C4, NOTE_G4};
-        int i = 0;
-        for (i = 0; i < 3; i++)
+        now = TA1R;
+    } while (now != TA1R);
+    return now;
+}
+
+/* Sets voice v to the note it points at, following repeat marks,
+ * and moves its note_end on by the note's length. Returns 0 at the
+ * end of the song.
+ */
+int play_note(int v)
+{
+    struct voice *voice = &voices[v];
+    const struct note *note = voice->note;
+
+    while (note->step == NOTE_REPEAT)
+    {
+        if (voice->repeats == 0)
         {
-            int period = 1000000 / music[i];
-            TA0CCR0 = period;
-            TA0CCR1 = period / 2;
-            // delay for 0.5 seconds
-            __delay_cycles(1000000);
+            voice->repeats = (note->ticks >> 8) + 1;
         }
+        if (--voice->repeats != 0)
+        {
+            note -= note->ticks & 0xFF;
+        }
+        else
+        {
+            note++;
+        }
+    }
+    voice->note = note;
+    if (note->ticks == 0)
+    {
+        return 0;
+    }
+    voice->step = scale(note->step, voice->scale); // 0 for a rest
+    *note_end[v] += scale(note->ticks, tempo_scale) | 1;
+    return 1;
+}
+
+int voices_playing()
+{
+    int v;
+
+    for (v = 0; v < SYNTH_VOICES; v++)
+    {
+        if (voices[v].song)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Points DMA 0 at output for the rest of the clip, carrying over
+ * the sample it last wrote
+ */
+void route_clip(volatile unsigned int *output)
+{
+    const struct clip *clip = clip_song->clip;
+    unsigned int left;
+
+    if (output == clip_output)
+    {
+        return;
     }
-    if (sel == 2)
+    DMA0CTL &= ~DMAEN;
+    if (DMA0CTL & DMAIFG)
     {
-        int music[] = {
-          NOTE_C4, NOTE_G4, NOTE_F4, NOTE_G4,
-          NOTE_C4, NOTE_G4, NOTE_F4, NOTE_G4,
-          NOTE_G4, NOTE_G4, NOTE_C4, NOTE_C4,
-          NOTE_C4, NOTE_C4, NOTE_F4, NOTE_G4
-        };
-        int i = 0;
-        for (i = 0; i < 14; i++)
+        return; // it ran out, DMA_ISR ends it next
+    }
+    left = DMA0SZ;
+    *output = *clip_output;
+    clip_output = output;
+    __data16_write_addr((unsigned short)&DMA0SA, (unsigned long)&clip->samples[clip->length - left]);
+    __data16_write_addr((unsigned short)&DMA0DA, (unsigned long)output);
+    DMA0SZ = left;
+    DMA0CTL |= DMAEN;
+}
+
+/* Runs the synthesizer's sample interrupt while a voice is playing,
+ * with the clip if any mixed in. A clip alone goes straight to the
+ * PWM and the interrupt stops; with nothing playing the PWM is quiet.
+ */
+void update_output()
+{
+    if (voices_playing())
+    {
+        if (clip_song)
         {
-            int period = 1000000 / music[i];
-            TA0CCR0 = period;
-            TA0CCR1 = period / 2;
-            // delay for 0.5 seconds
-            __delay_cycles(150000);
+            route_clip(&clip_sample);
         }
+        TA0CCTL0 = CCIE;
+        return;
     }
-    int music[2][3] = {
-        {300, 350, 300}, // score
-        {261, 261, 392}, // ball_hit
-    };
-    int i = 0;
-    for (i = 0; i < 3; i++)
+    TA0CCTL0 = 0;
+    if (clip_song)
     {
-        int period = 1000000 / music[sel][i];
-        TA0CCR0 = period;
-        TA0CCR1 = period / 2;
-        __delay_cycles(50000);
+        route_clip(&TA0CCR1);
+        return;
     }
-    TA0CCR0 = 0;
     TA0CCR1 = 0;
 }
+
+void stop_voice(int v)
+{
+    voices[v].step = 0;
+    voices[v].song = 0;
+    *note_control[v] = 0;
+    update_output();
+}
+
+/* Ends the clip playing, if any
+ */
+void stop_clip()
+{
+    DMA0CTL = 0;
+    TA2CTL = MC_0;
+    clip_song = 0;
+    clip_sample = 0;
+    update_output();
+}
+
+void stop_music()
+{
+    int v;
+
+    stop_clip();
+    for (v = 0; v < SYNTH_VOICES; v++)
+    {
+        stop_voice(v);
+    }
+}
+
+/* Streams song's clip at CLIP_RATE * step_scale / SCALE_ONE,
+ * cutting off the clip playing. Timer A2 triggers DMA 0 for every
+ * sample. With no voice playing it goes straight to TA0CCR1 and the
+ * CPU sleeps through the clip; a sample landing after TA0R passed
+ * the duty holds the output high to the end of that period. While a
+ * voice plays it goes to clip_sample instead, and the sample
+ * interrupt adds it to the voices so the music goes on under the
+ * clip (update_output() moves it between the two). DMA_ISR ends it.
+ */
+void play_clip(const struct song *song, unsigned int step_scale)
+{
+    const struct clip *clip = song->clip;
+
+    DMA0CTL = 0;
+    clip_song = song;
+    clip_output = voices_playing() ? &clip_sample : &TA0CCR1;
+    *clip_output = clip->samples[0];
+
+    __data16_write_addr((unsigned short)&DMA0SA, (unsigned long)&clip->samples[1]);
+    __data16_write_addr((unsigned short)&DMA0DA, (unsigned long)clip_output);
+    DMA0SZ = clip->length - 1;
+    DMA0CTL = DMADT_0 + DMASRCINCR_3 + DMADSTINCR_0 + DMASRCBYTE + DMAIE + DMAEN;
+
+    TA2CCR0 = (unsigned long)CLIP_PERIOD * SCALE_ONE / step_scale - 1;
+    TA2CTL = TASSEL_2 + MC_1 + TACLR; // SMCLK, up mode
+    update_output();
+}
+
+/* Starts song id on its voice with its steps scaled by
+ * step_scale / SCALE_ONE, cutting off whatever the voice was
+ * playing. Timer A1 moves on to the next note (next_note)
+ * and the CPU sleeps in between.
+ */
+void play_music(int id, unsigned int step_scale)
+{
+    const struct song *song = song_list[id];
+    int v = song->voice;
+    struct voice *voice = &voices[v];
+
+    voice->song = song;
+    voice->note = song->notes;
+    voice->repeats = 0;
+    voice->scale = step_scale;
+    voice->wave = waves[song->wave];
+    *note_end[v] = note_clock();
+    if (!play_note(v))
+    {
+        stop_voice(v);
+        return;
+    }
+    *note_control[v] = CCIE;
+    update_output();
+}
+
+/* Decides what a request for song id does, in constant time:
+ * - its voice quiet, or playing a lower priority song: id starts now
+ * - the same song still on its first note: merged into it
+ * - otherwise id waits its turn (a repeat waits only once)
+ * A recorded sound goes by the same rules against the clip playing,
+ * whatever the voices do, its first CLIP_MERGE samples standing for
+ * the first note.
+ */
+void request_song(int id, unsigned int step_scale)
+{
+    const struct song *requested = song_list[id];
+    const struct voice *voice = &voices[requested->voice];
+
+    if (requested->clip)
+    {
+        if (clip_song == 0 || requested->priority > clip_song->priority)
+        {
+            songs_pending &= ~requested->stale;
+            play_clip(requested, step_scale);
+        }
+        else if (requested != clip_song || !(DMA0CTL & DMAEN) || requested->clip->length - DMA0SZ > CLIP_MERGE)
+        {
+            songs_pending |= 1 << id;
+            pending_scale[id] = step_scale;
+        }
+        return;
+    }
+    if (requested->notes->ticks == 0)
+    {
+        return;
+    }
+    if (voice->song == 0 || requested->priority > voice->song->priority)
+    {
+        songs_pending &= ~requested->stale;
+        play_music(id, step_scale);
+    }
+    else if (requested != voice->song || voice->note != requested->notes)
+    {
+        songs_pending |= 1 << id;
+        pending_scale[id] = step_scale;
+    }
+}
+
+/* Voice v's note is over: its next note, the next song
+ * pending for it, or quiet
+ */
+void next_note(int v)
+{
+    int next;
+
+    voices[v].note++;
+    if (play_note(v))
+    {
+        return;
+    }
+    next = next_song[songs_pending & voice_songs[v]];
+    if (next >= 0)
+    {
+        songs_pending &= ~(1 << next);
+        songs_pending &= ~song_list[next]->stale;
+        play_music(next, pending_scale[next]);
+        return;
+    }
+    stop_voice(v);
+}
+
+/* Carries out a command frame that passed its checksum
+ */
+void run_command(const unsigned char *frame)
+{
+    int length = frame[2];
+    int i;
+    const unsigned char *payload = &frame[3];
+
+    switch (frame[1])
+    {
+    case AUDIO_PLAY_SONG:
+        if (length >= 1 && frame[3] < SONGS)
+        {
+            request_song(frame[3], SCALE_ONE);
+        }
+        break;
+    case AUDIO_PLAY_EFFECT:
+        if (length >= 2 && frame[3] < SONGS && frame[4] != 0)
+        {
+            request_song(frame[3], frame[4] * (SCALE_ONE / 16));
+        }
+        break;
+    case AUDIO_STOP:
+        songs_pending = 0;
+        stop_music();
+        break;
+    case AUDIO_SET_TEMPO:
+        if (length >= 1 && frame[3] >= 4)
+        {
+            tempo_scale = 16 * SCALE_ONE / frame[3];
+        }
+        break;
+    case AUDIO_UPLOAD:
+        if (voices[uploaded_song.voice].song == &uploaded_song)
+        {
+            stop_voice(uploaded_song.voice);
+        }
+        songs_pending &= ~(1 << SONG_UPLOADED);
+        for (i = 0; i < length / 4; i++, payload += 4)
+        {
+            uploaded_notes[i].step = payload[0] | (payload[1] << 8);
+            uploaded_notes[i].ticks = payload[2] | (payload[3] << 8);
+            if (uploaded_notes[i].step == NOTE_REPEAT)
+            {
+                break; // no repeats, they could jump out of the array
+            }
+        }
+        uploaded_notes[i].step = 0;
+        uploaded_notes[i].ticks = 0;
+        break;
+    }
+}
+
 int main(void)
 {
     WDTCTL = WDTPW | WDTHOLD; // stop watchdog timer
 
-    P6REN = BIT0 + BIT1;
-    P1REN |= BIT4;
-    P1OUT &= ~BIT4; // Enable pull-down resistor for P1.4
-    P1IE |= BIT4;   // Enable input at P1.4 as an interrupt
-    P1IES |= BIT4;  // Trigger on the rising edge for P1.4
-
-    init_PWM();
+    // Listen from the start: the game MCU sends the intro while this
+    // one still waits for its FLL (about 30ms). The first frame is
+    // kept for then, the ones after it are dropped
+    init_command_link();
+    __enable_interrupt();
+    init_clock();
+    init_synth();
+    __disable_interrupt();
+    synth_ready = 1;
+    if (command_held)
+    {
+        run_command(held_command);
+    }
+#ifdef SYNTH_PROFILE
+    synth_measure();
+#endif
 
     _BIS_SR(LPM0_bits + GIE); // Turn on interrupts and go into the lowest power mode with GPIO enabled
                               // Turn on interrupts and go into the lowest
@@ -177,12 +617,90 @@ int main(void)
     return 0;
 }
 
-// set up interrupt
-void __attribute__((interrupt(PORT1_VECTOR))) PORT1_ISR(void) // Port 1 interrupt service routine
+// Collects a command frame byte by byte, runs it when it is complete
+void __attribute__((interrupt(USCI_B1_VECTOR))) USCI_B1_ISR(void)
+{
+    unsigned char byte = UCB1RXBUF;
+    int i;
+
+    if (command_bytes == 0)
+    {
+        if (byte == AUDIO_SYNC)
+        {
+            command_bytes = 1;
+            command_sum = 0;
+        }
+        return;
+    }
+    if (command_bytes == 2 && byte > AUDIO_MAX_PAYLOAD)
+    {
+        command_bytes = 0; // not a frame we sent, wait for the next sync
+        return;
+    }
+    command[command_bytes++] = byte;
+    if (command_bytes > 2 && command_bytes == command[2] + 4)
+    {
+        command_bytes = 0;
+        if (byte == command_sum && synth_ready)
+        {
+            run_command(command);
+        }
+        else if (byte == command_sum && !command_held)
+        {
+            for (i = 0; i < AUDIO_FRAME_SIZE; i++)
+            {
+                held_command[i] = command[i]; // command[] takes the next frame
+            }
+            command_held = 1;
+        }
+        return;
+    }
+    command_sum += byte;
+}
+
+// One sample while a voice plays: the mixed voices and clip set the PWM duty
+void __attribute__((interrupt(TIMER0_A0_VECTOR))) TIMER0_A0_ISR(void)
+{
+    TA0CCR1 = mix(SYNTH_VOICES) + clip_sample;
+    SYNTH_PROFILE_END();
+}
+
+// The clip has run out, on to the next one pending
+void __attribute__((interrupt(DMA_VECTOR))) DMA_ISR(void)
 {
-    P1IFG &= ~BIT4;        // Clear interrupt flag
-    __delay_cycles(20000); // Add debounce delay
-    int sel = P6IN & (BIT0 + BIT1);
-    play_music(sel);
-    reset_msp430();
+    int next;
+
+    switch (__even_in_range(DMAIV, 16))
+    {
+    case 2: // DMA 0
+        stop_clip();
+        next = next_song[songs_pending & clip_songs];
+        if (next >= 0)
+        {
+            songs_pending &= ~(1 << next);
+            songs_pending &= ~song_list[next]->stale;
+            play_clip(song_list[next], pending_scale[next]);
+        }
+        break;
+    }
+}
+
+// End of a note on voice 0
+void __attribute__((interrupt(TIMER1_A0_VECTOR))) TIMER1_A0_ISR(void)
+{
+    next_note(0);
+}
+
+// End of a note on voice 1 or 2
+void __attribute__((interrupt(TIMER1_A1_VECTOR))) TIMER1_A1_ISR(void)
+{
+    switch (__even_in_range(TA1IV, 14))
+    {
+    case 2: // TA1CCR1
+        next_note(1);
+        break;
+    case 4: // TA1CCR2
+        next_note(2);
+        break;
+    }
 }
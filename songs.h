@@ -0,0 +1,48 @@
+/* Generated by tools/song_table.c from tools/songs.txt, do not edit.
+ *
+ * Every song is a struct note array ending with {0, 0}, see
+ * audio_link.h for the entry types.
+ */
+
+const struct note score_notes[] =
+{
+    {NOTE_STEP(300), NOTE_MS(50)}, // 300
+    {NOTE_STEP(350), NOTE_MS(50)}, // 350
+    {NOTE_STEP(300), NOTE_MS(50)}, // 300
+    {0, 0},
+};
+
+const struct note hit_notes[] =
+{
+    {NOTE_STEP(261), NOTE_MS(50)}, // 261
+    {NOTE_STEP(261), NOTE_MS(50)}, // 261
+    {NOTE_STEP(392), NOTE_MS(50)}, // G4
+    {0, 0},
+};
+
+const struct note intro_notes[] =
+{
+    {NOTE_STEP(262), NOTE_MS(150)}, // C4
+    {NOTE_STEP(392), NOTE_MS(150)}, // G4
+    {NOTE_STEP(349), NOTE_MS(150)}, // F4
+    {NOTE_STEP(392), NOTE_MS(150)}, // G4
+    {NOTE_REPEAT, NOTE_AGAIN(1, 4)},
+    {NOTE_STEP(392), NOTE_MS(150)}, // G4
+    {NOTE_STEP(392), NOTE_MS(150)}, // G4
+    {NOTE_STEP(262), NOTE_MS(150)}, // C4
+    {NOTE_STEP(262), NOTE_MS(150)}, // C4
+    {NOTE_STEP(262), NOTE_MS(150)}, // C4
+    {NOTE_STEP(262), NOTE_MS(150)}, // C4
+    {NOTE_STEP(349), NOTE_MS(150)}, // F4
+    {NOTE_STEP(392), NOTE_MS(150)}, // G4
+    {0, 0},
+};
+
+const struct note game_over_notes[] =
+{
+    {NOTE_STEP(392), NOTE_MS(1000)}, // G4
+    {NOTE_STEP(262), NOTE_MS(1000)}, // C4
+    {NOTE_STEP(392), NOTE_MS(1000)}, // G4
+    {0, 0},
+};
+
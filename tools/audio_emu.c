@@ -0,0 +1,677 @@
+/* audio_emu.c
+ * Host harness that runs music.c against emulated timers, DMA and the
+ * SPI command link, renders the PWM on P1.2 to a WAV file and reports
+ * the pitch, note lengths and trigger-to-sound latency of every song.
+ *
+ *   gcc -O2 -Itools/emu -I. -o audio_emu tools/audio_emu.c -lm
+ *   ./audio_emu -c -w songs.wav                 every song in turn, checked
+ *   ./audio_emu -w mix.wav 0:2 300:1:24 450:0   ms:song[:pitch] triggers
+ *   ./audio_emu -c -b 0:2                       the intro sent during boot
+ *   ./audio_emu -c 200:1 205:1                  two close hits, one clip
+ *
+ *   -w file    write what the piezo gets (the PWM averaged, DC removed)
+ *   -c         check every song that plays out alone against its table
+ *              in songs.h or clips.h, exit 1 on a mismatch
+ *   -t tempo   send AUDIO_SET_TEMPO first (16ths, see audio_link.h)
+ *   -b         send the first trigger from power-up, a hit on its heels:
+ *              both frames come in while init_clock() waits for the FLL
+ *              and the first has to play out as if it came later
+ *   -v         list the notes found in every song
+ *
+ * A trigger sends the frame play_music() (or play_effect() with a
+ * pitch) sends on the game MCU, a byte every 8 x AUDIO_LINK_DIVIDER
+ * cycles of its 1MHz SMCLK. The latency is from the start of that
+ * frame to the first PWM period with a new duty. Without triggers every
+ * song plays in turn, each QUIET_MS after the last one went quiet.
+ * A clip asked for again within CLIP_MERGE samples of its onset is
+ * merged into it: with -c the two together have to last one clip.
+ *
+ * Interrupts take no time here: the latency is what the link and the
+ * timers add, the cycles the handlers cost are for tools/msp430_sim.c.
+ * Before main() sleeps only __delay_cycles() passes time, and link
+ * bytes come in then only between __enable_interrupt() and
+ * __disable_interrupt().
+ * Timer A1 is taken to count ACLK / 2 and the DMA to be triggered by
+ * TA2CCR0, as music.c sets them up.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define main music_main
+#include <music.c>
+#undef main
+
+#define WAV_RATE 32000
+#define GAME_SMCLK_HZ 1000000UL
+#define BYTE_CYCLES (8UL * AUDIO_LINK_DIVIDER * AUDIO_MCLK_HZ / GAME_SMCLK_HZ)
+#define TICK_CYCLES (AUDIO_MCLK_HZ / SONG_TICK_HZ)
+#define MAX_SECONDS 60
+#define QUIET_MS 100
+#define MAX_TRIGGERS 64
+#define MAX_BYTES (MAX_TRIGGERS * AUDIO_FRAME_SIZE + AUDIO_FRAME_SIZE)
+#define MAX_NOTES 256
+#define PITCH_TOLERANCE 0.01 // of the expected frequency
+#define RUN_TOLERANCE 0.03   // periods within a note
+#define MIN_PERIODS 4 // shorter runs are where one note meets the next
+#define RUN_JITTER (1.5 * WAV_RATE / SYNTH_RATE) // the DDS moves a crossing a synth period
+
+typedef unsigned long long cycles;
+
+struct trigger
+{
+    cycles at;
+    int song;
+    int pitch; // 16ths, 0 for play_music()
+    cycles onset;
+    cycles end;
+    int alone; // started with nothing playing and played out
+    int merged; // the clip of the trigger before, asked for as it started
+} triggers[MAX_TRIGGERS];
+int trigger_count = 0;
+int next_trigger = 0;
+int sounding = -1; // trigger waiting for its onset or end
+
+struct byte
+{
+    cycles at;
+    unsigned char value;
+} bytes[MAX_BYTES];
+int byte_count = 0;
+int next_byte = 0;
+
+cycles now = 0;
+cycles ta0_start, ta0_next, ta1_next, ta2_next;
+unsigned int duty = 0; // TA0CCR1 for the TA0 period under way
+int auto_triggers = 0;
+int tempo = 16;
+int emu_interrupts = 0;
+
+double *level; // PWM average per WAV sample, 0..1
+long level_count;
+
+/* The host address music.c gives the DMA, told apart by the low
+ * bits of the register's address */
+void emu_write_addr(unsigned short reg, unsigned long address)
+{
+    if (reg == (unsigned short)(unsigned long)&DMA0SA)
+    {
+        DMA0SA = address;
+    }
+    else if (reg == (unsigned short)(unsigned long)&DMA0DA)
+    {
+        DMA0DA = address;
+    }
+}
+
+/* Boot time: nothing runs but the link */
+void emu_delay(unsigned long count)
+{
+    cycles end = now + count;
+
+    while (emu_interrupts && next_byte < byte_count && bytes[next_byte].at <= end)
+    {
+        now = bytes[next_byte].at;
+        UCB1RXBUF = bytes[next_byte++].value;
+        if (UCB1IE & UCRXIE)
+        {
+            USCI_B1_ISR();
+        }
+    }
+    now = end;
+}
+
+/* Adds the PWM's average from from to to, value being the part of
+ * the period it is high */
+void render(cycles from, cycles to, double value)
+{
+    double per_sample = (double)AUDIO_MCLK_HZ / WAV_RATE;
+    double at = from / per_sample, end = to / per_sample;
+
+    while (at < end)
+    {
+        long bin = (long)at;
+        double next = bin + 1 < end ? bin + 1 : end;
+        if (bin >= level_count)
+        {
+            return;
+        }
+        level[bin] += (next - at) * value;
+        at = next;
+    }
+}
+
+void queue_frame(cycles at, int command, const unsigned char *payload, int length)
+{
+    unsigned char frame[AUDIO_FRAME_SIZE];
+    unsigned char sum = command + length;
+    int i;
+
+    frame[0] = AUDIO_SYNC;
+    frame[1] = command;
+    frame[2] = length;
+    for (i = 0; i < length; i++)
+    {
+        frame[3 + i] = payload[i];
+        sum += payload[i];
+    }
+    frame[3 + length] = sum;
+    for (i = 0; i < length + 4 && byte_count < MAX_BYTES; i++)
+    {
+        bytes[byte_count].at = at + (i + 1) * BYTE_CYCLES;
+        bytes[byte_count].value = frame[i];
+        byte_count++;
+    }
+}
+
+int quiet(void)
+{
+    return !(TA0CCTL0 & CCIE) && !(DMA0CTL & DMAEN);
+}
+
+void start_trigger(struct trigger *trigger)
+{
+    unsigned char payload[2];
+
+    payload[0] = trigger->song;
+    payload[1] = trigger->pitch;
+    if (trigger->pitch)
+    {
+        queue_frame(now, AUDIO_PLAY_EFFECT, payload, 2);
+    }
+    else
+    {
+        queue_frame(now, AUDIO_PLAY_SONG, payload, 1);
+    }
+    trigger->at = now;
+    trigger->alone = sounding < 0 && quiet();
+    sounding = trigger - triggers;
+}
+
+/* Whether music.c takes trigger as the clip playing, started by
+ * the trigger before on its own */
+int merges(const struct trigger *trigger, const struct trigger *playing)
+{
+    return song_list[trigger->song]->clip && trigger->song == playing->song && playing->alone && !playing->end &&
+           (!playing->onset || now - playing->onset < (cycles)CLIP_MERGE * CLIP_PERIOD);
+}
+
+/* Picks up TACLR and register changes the handlers made */
+void sync_timers(void)
+{
+    if (TA0CTL & TACLR)
+    {
+        TA0CTL &= ~TACLR;
+        render(ta0_start, now, (double)(duty < now - ta0_start ? duty : now - ta0_start) / (now - ta0_start));
+        ta0_start = now;
+        duty = TA0CCR1 & 0xFFFF;
+    }
+    ta0_next = ta0_start + (TA0CCR0 & 0xFFFF) + 1;
+    if (ta0_next <= now)
+    {
+        ta0_next = now + 1;
+    }
+    if (TA1CTL & TACLR)
+    {
+        TA1CTL &= ~TACLR;
+        TA1R = 0;
+        ta1_next = now + TICK_CYCLES;
+    }
+    if (TA2CTL & TACLR)
+    {
+        TA2CTL &= ~TACLR;
+        ta2_next = now + (TA2CCR0 & 0xFFFF) + 1;
+    }
+}
+
+void ta0_period(void)
+{
+    unsigned int period = (unsigned int)(ta0_next - ta0_start);
+
+    render(ta0_start, ta0_next, (double)(duty < period ? duty : period) / period);
+    if (TA0CCTL0 & CCIE)
+    {
+        TIMER0_A0_ISR();
+    }
+    ta0_start = ta0_next;
+    if (sounding >= 0 && !triggers[sounding].onset && (TA0CCR1 & 0xFFFF) != duty)
+    {
+        triggers[sounding].onset = ta0_start;
+    }
+    duty = TA0CCR1 & 0xFFFF;
+}
+
+void ta1_tick(void)
+{
+    volatile unsigned int *const control[3] = {&TA1CCTL0, &TA1CCTL1, &TA1CCTL2};
+    volatile unsigned int *const compare[3] = {&TA1CCR0, &TA1CCR1, &TA1CCR2};
+    int n;
+
+    ta1_next += TICK_CYCLES;
+    if ((TA1CTL & MC_3) != MC_2)
+    {
+        return;
+    }
+    TA1R = (TA1R + 1) & 0xFFFF;
+    for (n = 0; n < 3; n++)
+    {
+        if ((*control[n] & CCIE) && (*compare[n] & 0xFFFF) == TA1R)
+        {
+            if (n == 0)
+            {
+                TIMER1_A0_ISR();
+            }
+            else
+            {
+                TA1IV = 2 * n;
+                TIMER1_A1_ISR();
+            }
+        }
+    }
+}
+
+void ta2_period(void)
+{
+    ta2_next = now + (TA2CCR0 & 0xFFFF) + 1;
+    if ((TA2CTL & MC_3) != MC_1 || (DMACTL0 & 0x1F) != DMA0TSEL_5 || !(DMA0CTL & DMAEN))
+    {
+        return;
+    }
+    *(volatile unsigned int *)DMA0DA = *(const unsigned char *)DMA0SA;
+    DMA0SA++;
+    DMA0SZ = (DMA0SZ - 1) & 0xFFFF;
+    if (DMA0SZ == 0)
+    {
+        DMA0CTL = (DMA0CTL & ~DMAEN) | DMAIFG;
+        if (DMA0CTL & DMAIE)
+        {
+            DMAIV = 2;
+            DMA_ISR();
+        }
+        DMA0CTL &= ~DMAIFG;
+    }
+}
+
+void run(cycles end)
+{
+    while (now < end)
+    {
+        cycles next = ta0_next;
+        int running_ta2 = (TA2CTL & MC_3) == MC_1;
+
+        if (ta1_next < next)
+            next = ta1_next;
+        if (running_ta2 && ta2_next < next)
+            next = ta2_next;
+        if (next_byte < byte_count && bytes[next_byte].at < next)
+            next = bytes[next_byte].at;
+        now = next;
+
+        if (next_byte < byte_count && bytes[next_byte].at == now)
+        {
+            UCB1RXBUF = bytes[next_byte++].value;
+            if (UCB1IE & UCRXIE)
+            {
+                USCI_B1_ISR();
+            }
+        }
+        else if (running_ta2 && ta2_next == now)
+        {
+            ta2_period();
+        }
+        else if (ta1_next == now)
+        {
+            ta1_tick();
+        }
+        else
+        {
+            ta0_period();
+        }
+        sync_timers();
+
+        if (sounding >= 0 && triggers[sounding].onset && !triggers[sounding].end && quiet())
+        {
+            triggers[sounding].end = now;
+            sounding = -1;
+        }
+        if (next_trigger < trigger_count && next_byte == byte_count)
+        {
+            struct trigger *trigger = &triggers[next_trigger];
+            cycles wait = (cycles)QUIET_MS * AUDIO_MCLK_HZ / 1000;
+            int due = auto_triggers ? quiet() && sounding < 0 && now >= (next_trigger ? triggers[next_trigger - 1].end : 0) + wait
+                                    : now >= trigger->at;
+            if (due)
+            {
+                trigger->merged = sounding >= 0 && merges(trigger, &triggers[sounding]);
+                if (sounding >= 0 && !triggers[sounding].end)
+                {
+                    triggers[sounding].end = now; // cut off
+                    triggers[sounding].alone = 0;
+                }
+                start_trigger(trigger);
+                next_trigger++;
+            }
+        }
+        if (next_trigger == trigger_count && sounding < 0 && next_byte == byte_count && quiet())
+        {
+            end = now + (cycles)QUIET_MS * AUDIO_MCLK_HZ / 1000 < end ? now + (cycles)QUIET_MS * AUDIO_MCLK_HZ / 1000 : end;
+        }
+    }
+}
+
+/* Analysis */
+
+struct found
+{
+    double start; // ms
+    double length;
+    double hz;
+} notes[MAX_NOTES];
+int note_count;
+
+struct expected
+{
+    double hz; // 0 for a rest
+    double ms;
+} expected[MAX_NOTES];
+int expected_count;
+
+double *wave; // level with the DC taken out
+
+void remove_dc(void)
+{
+    double mean = 0, a = 2 * 3.14159265 * 20 / WAV_RATE;
+    long i;
+
+    wave = malloc(sizeof(double) * level_count);
+    for (i = 0; i < level_count; i++)
+    {
+        double x = level[i];
+        mean += (x - mean) * a;
+        wave[i] = x - mean;
+    }
+}
+
+/* Splits the sound between from and to (WAV samples) into notes, a
+ * note being a run of rising zero crossings the same distance apart */
+void find_notes(long from, long to)
+{
+    double crossing[4096];
+    int count = 0, first;
+    long s;
+
+    note_count = 0;
+    for (s = from + 1; s < to && s < level_count && count < 4096; s++)
+    {
+        if (wave[s - 1] < 0 && wave[s] >= 0)
+        {
+            crossing[count++] = s - 1 + wave[s - 1] / (wave[s - 1] - wave[s]);
+        }
+    }
+    for (first = 0; first + 2 < count && note_count < MAX_NOTES;)
+    {
+        double period = crossing[first + 1] - crossing[first];
+        int last = first + 1;
+        while (last + 1 < count)
+        {
+            double next = crossing[last + 1] - crossing[last];
+            double mean = (crossing[last] - crossing[first]) / (last - first);
+            if (fabs(next - mean) > mean * RUN_TOLERANCE && fabs(next - mean) > RUN_JITTER)
+            {
+                break;
+            }
+            last++;
+        }
+        if (last - first >= MIN_PERIODS)
+        {
+            period = (crossing[last] - crossing[first]) / (last - first);
+            notes[note_count].start = crossing[first] * 1000 / WAV_RATE;
+            notes[note_count].length = (crossing[last] - crossing[first] + period) * 1000 / WAV_RATE;
+            notes[note_count].hz = WAV_RATE / period;
+            note_count++;
+        }
+        first = last;
+    }
+    // The DC filter hides the first crossings, so the sound's own
+    // onset and end bound the first and last notes
+    if (note_count > 0)
+    {
+        notes[0].length += notes[0].start - from * 1000.0 / WAV_RATE;
+        notes[0].start = from * 1000.0 / WAV_RATE;
+        notes[note_count - 1].length = to * 1000.0 / WAV_RATE - notes[note_count - 1].start;
+    }
+}
+
+/* The notes a song should sound like: repeats played out, notes of
+ * the same pitch run together (the voice keeps its phase) */
+void expect_song(const struct song *song, int pitch)
+{
+    const struct note *note = song->notes;
+    int repeats = 0;
+
+    expected_count = 0;
+    while (note->ticks != 0 && expected_count < MAX_NOTES)
+    {
+        double hz, ms;
+        if (note->step == NOTE_REPEAT)
+        {
+            if (repeats == 0)
+            {
+                repeats = (note->ticks >> 8) + 1;
+            }
+            note = --repeats ? note - (note->ticks & 0xFF) : note + 1;
+            continue;
+        }
+        hz = (double)note->step * SYNTH_RATE / 65536 * (pitch ? pitch : 16) / 16;
+        ms = (double)note->ticks * 1000 / SONG_TICK_HZ * 16 / tempo;
+        if (expected_count > 0 && expected[expected_count - 1].hz == hz)
+        {
+            expected[expected_count - 1].ms += ms;
+        }
+        else
+        {
+            expected[expected_count].hz = hz;
+            expected[expected_count].ms = ms;
+            expected_count++;
+        }
+        note++;
+    }
+}
+
+/* Returns 0 if the notes found match the song's table */
+int check_song(int verbose)
+{
+    int i, n = 0, failed = 0;
+
+    for (i = 0; i < expected_count; i++)
+    {
+        double period_ms;
+        if (expected[i].hz == 0)
+        {
+            continue; // rests show up as the gap between notes
+        }
+        period_ms = 1000 / expected[i].hz;
+        if (n >= note_count)
+        {
+            if (verbose)
+                printf("    missing %.1f Hz %.1f ms\n", expected[i].hz, expected[i].ms);
+            failed = 1;
+            continue;
+        }
+        if (fabs(notes[n].hz - expected[i].hz) > expected[i].hz * PITCH_TOLERANCE ||
+            fabs(notes[n].length - expected[i].ms) > 2 * period_ms + 2)
+        {
+            if (verbose)
+                printf("    expected %.1f Hz %.1f ms\n", expected[i].hz, expected[i].ms);
+            failed = 1;
+        }
+        n++;
+    }
+    return failed || n != note_count;
+}
+
+void write_wav(const char *file)
+{
+    FILE *f = fopen(file, "wb");
+    unsigned char header[44];
+    long i, data = level_count * 2;
+
+    if (!f)
+    {
+        perror(file);
+        exit(1);
+    }
+    memcpy(header, "RIFF\0\0\0\0WAVEfmt \x10\0\0\0\x01\0\x01\0\0\0\0\0\0\0\0\0\x02\0\x10\0data\0\0\0\0", 44);
+    for (i = 0; i < 4; i++)
+    {
+        header[4 + i] = ((36 + data) >> (8 * i)) & 0xFF;
+        header[24 + i] = ((long)WAV_RATE >> (8 * i)) & 0xFF;
+        header[28 + i] = ((long)WAV_RATE * 2 >> (8 * i)) & 0xFF;
+        header[40 + i] = (data >> (8 * i)) & 0xFF;
+    }
+    fwrite(header, 1, 44, f);
+    for (i = 0; i < level_count; i++)
+    {
+        long sample = (long)(wave[i] * 60000);
+        if (sample > 32767)
+            sample = 32767;
+        if (sample < -32768)
+            sample = -32768;
+        fputc(sample & 0xFF, f);
+        fputc((sample >> 8) & 0xFF, f);
+    }
+    fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+    const char *wav_file = 0;
+    const char *song_names[SONGS] = {"score", "hit", "intro", "game_over", "uploaded"};
+    int check = 0, verbose = 0, boot = 0, failed = 0, i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            wav_file = argv[++i];
+        else if (strcmp(argv[i], "-c") == 0)
+            check = 1;
+        else if (strcmp(argv[i], "-v") == 0)
+            verbose = 1;
+        else if (strcmp(argv[i], "-b") == 0)
+            boot = 1;
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            tempo = atoi(argv[++i]);
+        else if (trigger_count < MAX_TRIGGERS)
+        {
+            double ms = 0;
+            int song = 0, pitch = 0;
+            if (sscanf(argv[i], "%lf:%d:%d", &ms, &song, &pitch) < 2 || song < 0 || song >= SONGS)
+            {
+                fprintf(stderr, "usage: %s [-c] [-v] [-b] [-t tempo] [-w out.wav] [ms:song[:pitch] ...]\n", argv[0]);
+                return 1;
+            }
+            triggers[trigger_count].at = (cycles)(ms * AUDIO_MCLK_HZ / 1000);
+            triggers[trigger_count].song = song;
+            triggers[trigger_count].pitch = pitch;
+            trigger_count++;
+        }
+    }
+    if (trigger_count == 0)
+    {
+        auto_triggers = 1;
+        for (i = 0; i < SONG_UPLOADED; i++)
+        {
+            triggers[trigger_count++].song = i;
+        }
+    }
+    if (tempo < 4 || tempo > 255)
+    {
+        fprintf(stderr, "tempo is 4..255\n");
+        return 1;
+    }
+    if (boot && tempo != 16)
+    {
+        fprintf(stderr, "-b sends its frames first, -t has to wait\n");
+        return 1;
+    }
+
+    level_count = (long)MAX_SECONDS * WAV_RATE;
+    level = calloc(level_count, sizeof(double));
+    PMMIFG = SVSMLDLYIFG; // the core voltage is up at once
+    if (boot)
+    {
+        unsigned char hit[2] = {SONG_HIT, 16};
+
+        start_trigger(&triggers[next_trigger++]);
+        queue_frame(bytes[byte_count - 1].at, AUDIO_PLAY_EFFECT, hit, 2);
+    }
+    music_main();
+    sync_timers();
+    ta1_next = now + TICK_CYCLES;
+    if (tempo != 16)
+    {
+        unsigned char payload = tempo;
+        queue_frame(0, AUDIO_SET_TEMPO, &payload, 1);
+    }
+    run((cycles)MAX_SECONDS * AUDIO_MCLK_HZ);
+    level_count = (long)(now * WAV_RATE / AUDIO_MCLK_HZ);
+    remove_dc();
+
+    printf("trigger  at ms  song       latency us  length ms  expected ms  result\n");
+    for (i = 0; i < trigger_count; i++)
+    {
+        struct trigger *t = &triggers[i];
+        const struct song *song = song_list[t->song];
+        double latency = t->onset ? (double)(t->onset - t->at) * 1e6 / AUDIO_MCLK_HZ : 0;
+        double length = t->end ? (double)(t->end - t->onset) * 1000 / AUDIO_MCLK_HZ : 0;
+        double expected_ms = 0;
+        const char *result = "";
+        int n;
+
+        if (t->merged)
+        {
+            length = t->end ? (double)(t->end - triggers[i - 1].onset) * 1000 / AUDIO_MCLK_HZ : 0;
+        }
+        if (song->clip)
+        {
+            int pitch = t->merged ? triggers[i - 1].pitch : t->pitch;
+            expected_ms = (double)song->clip->length * 1000 / CLIP_RATE * 16 / (pitch ? pitch : 16);
+            expected_count = 0;
+        }
+        else
+        {
+            expect_song(song, t->pitch);
+            for (n = 0; n < expected_count; n++)
+            {
+                expected_ms += expected[n].ms;
+            }
+        }
+        find_notes((long)(t->onset * WAV_RATE / AUDIO_MCLK_HZ), (long)(t->end * WAV_RATE / AUDIO_MCLK_HZ));
+        if (check && t->onset && t->end && (t->alone || t->merged))
+        {
+            int bad = fabs(length - expected_ms) > 2 || (!song->clip && check_song(verbose));
+            result = bad ? "FAIL" : "ok";
+            failed |= bad;
+        }
+        else if (check)
+        {
+            result = !t->onset ? "FAIL (no sound)" : t->end ? "overlapped" : "unfinished";
+            failed |= !t->onset;
+        }
+        printf("%7d %6.0f  %-10s %10.0f %10.1f %12.1f  %s\n", i, (double)t->at * 1000 / AUDIO_MCLK_HZ,
+               song_names[t->song], latency, length, expected_ms, result);
+        if (verbose && !song->clip)
+        {
+            for (n = 0; n < note_count; n++)
+            {
+                printf("    %8.1f ms  %7.1f Hz  %7.1f ms\n", notes[n].start, notes[n].hz, notes[n].length);
+            }
+        }
+    }
+    if (wav_file)
+    {
+        write_wav(wav_file);
+    }
+    return failed;
+}
@@ -0,0 +1,123 @@
+/* msp430.h for tools/game_emu.c
+ * The registers main.c touches. Most are plain variables; the ones
+ * the game clocks the LCD through, polls or starts transfers with
+ * go through emu_reg(), so the emulator sees every access and has
+ * the last write in hand by the next one. Bit values follow
+ * msp430f5529.h. Registers are wider than 16 bits on the host, so
+ * the emulator masks what it reads.
+ */
+#ifndef EMU_MSP430_H
+#define EMU_MSP430_H
+
+#define interrupt(vector) used
+
+#define REG8(name) volatile unsigned char name;
+#define REG16(name) volatile unsigned int name;
+
+REG16(WDTCTL)
+REG8(P2DIR) REG8(P2REN) REG8(P2OUT)
+REG8(P3DIR)
+REG8(P4DIR) REG8(P4OUT) REG8(P4SEL) REG8(P6SEL)
+REG8(P7DIR) REG8(P7OUT) REG8(P8DIR) REG8(P8OUT)
+REG16(PMAPKEYID) REG8(P4MAP6) REG8(P4MAP7)
+REG16(TA0CTL) REG16(TA0CCTL0) REG16(TA0CCR0)
+REG16(TA1CTL)
+REG16(ADC12CTL0) REG8(ADC12MCTL0) REG16(ADC12MEM0)
+REG8(UCA1CTL1) REG8(UCA1BR0) REG8(UCA1BR1) REG8(UCA1MCTL) REG8(UCA1IE) REG8(UCA1RXBUF)
+REG8(UCB1CTL0) REG8(UCB1CTL1) REG8(UCB1BR0) REG8(UCB1BR1) REG8(UCB1IFG)
+REG16(DMACTL0) REG16(DMA1SZ)
+REG16(DMA1SA) REG16(DMA1DA) // only their addresses are taken
+REG16(FCTL3)
+
+#define EMU_P2IN 0      // the button, from the script
+#define EMU_P3OUT 1     // the LCD bus
+#define EMU_TA1R 2      // counts from the emulator's clock
+#define EMU_ADC12CTL1 3 // a read finishes the conversion ADC12SC started
+#define EMU_UCA1IFG 4
+#define EMU_UCA1TXBUF 5
+#define EMU_UCB1TXBUF 6 // starts an audio frame
+#define EMU_DMA1CTL 7
+#define EMU_FCTL1 8     // erases and writes show up at the next access
+#define EMU_REGS 9
+
+#define P2IN (*emu_reg(EMU_P2IN))
+#define P3OUT (*emu_reg(EMU_P3OUT))
+#define TA1R (*emu_reg(EMU_TA1R))
+#define ADC12CTL1 (*emu_reg(EMU_ADC12CTL1))
+#define UCA1IFG (*emu_reg(EMU_UCA1IFG))
+#define UCA1TXBUF (*emu_reg(EMU_UCA1TXBUF))
+#define UCB1TXBUF (*emu_reg(EMU_UCB1TXBUF))
+#define DMA1CTL (*emu_reg(EMU_DMA1CTL))
+#define FCTL1 (*emu_reg(EMU_FCTL1))
+
+#define BIT0 0x0001
+#define BIT1 0x0002
+#define BIT2 0x0004
+#define BIT3 0x0008
+#define BIT4 0x0010
+#define BIT5 0x0020
+#define BIT6 0x0040
+#define BIT7 0x0080
+
+#define WDTPW 0x5A00
+#define WDTHOLD 0x0080
+#define GIE 0x0008
+
+#define TACLR 0x0004
+#define MC_1 0x0010
+#define MC_2 0x0020
+#define MC_3 0x0030
+#define ID_3 0x00C0
+#define TASSEL_1 0x0100
+#define TASSEL_2 0x0200
+#define CCIE 0x0010
+
+#define ADC12SC 0x0001
+#define ADC12ENC 0x0002
+#define ADC12ON 0x0010
+#define ADC12SHT02 0x0200
+#define ADC12SHP 0x0200
+#define ADC12BUSY 0x0001
+#define ADC12INCH_0 0x0000
+
+#define UCSWRST 0x01
+#define UCSSEL_2 0x80
+#define UCBRS_1 0x02
+#define UCBRF_0 0x00
+#define UCSYNC 0x01
+#define UCMST 0x08
+#define UCMSB 0x20
+#define UCCKPH 0x80
+#define UCRXIE 0x01
+#define UCRXIFG 0x01
+#define UCTXIFG 0x02
+
+// Port mapping: nothing is mapped here, the audio link is emulated as a whole
+#define PMAPKEY 0x2D52
+#define PM_UCB1SIMO 1
+#define PM_UCB1CLK 2
+
+#define DMA1TSEL_23 0x1700
+#define DMADT_0 0x0000
+#define DMASRCINCR_3 0x0300
+#define DMADSTINCR_0 0x0000
+#define DMASBDB 0x00C0
+#define DMAEN 0x0010
+
+#define FWKEY 0xA500
+#define ERASE 0x0002
+#define WRT 0x0040
+#define LOCK 0x0010
+#define LOCKA 0x0040
+
+#define __enable_interrupt() (emu_interrupts = 1)
+#define __disable_interrupt() (emu_interrupts = 0)
+#define __get_SR_register() (emu_interrupts ? GIE : 0)
+#define __delay_cycles(cycles) emu_delay(cycles)
+#define __data16_write_addr(reg, address) ((void)(address)) // DMA1 is timed, not run
+
+volatile unsigned int *emu_reg(int reg);
+void emu_delay(unsigned long count); // the timer interrupt and link bytes come in meanwhile
+extern int emu_interrupts;
+
+#endif
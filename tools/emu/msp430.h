@@ -0,0 +1,102 @@
+/* msp430.h for tools/audio_emu.c
+ * The registers music.c touches, as plain variables the emulator
+ * reads and writes. Bit values follow msp430f5529.h. Registers are
+ * wider than 16 bits on the host, so the emulator masks what it reads.
+ */
+#ifndef EMU_MSP430_H
+#define EMU_MSP430_H
+
+#define interrupt(vector) used
+
+#define REG8(name) volatile unsigned char name;
+#define REG16(name) volatile unsigned int name;
+
+REG16(WDTCTL)
+REG8(P1DIR) REG8(P1SEL) REG8(P4SEL)
+REG16(TA0CTL) REG16(TA0CCTL0) REG16(TA0CCTL1) REG16(TA0CCR0) REG16(TA0CCR1) REG16(TA0R)
+REG16(TA1CTL) REG16(TA1CCTL0) REG16(TA1CCTL1) REG16(TA1CCTL2)
+REG16(TA1CCR0) REG16(TA1CCR1) REG16(TA1CCR2) REG16(TA1R) REG16(TA1IV)
+REG16(TA2CTL) REG16(TA2CCR0)
+REG16(DMACTL0) REG16(DMA0CTL) REG16(DMA0SZ) REG16(DMAIV)
+unsigned long DMA0SA, DMA0DA; // host addresses, see __data16_write_addr
+REG8(UCB1CTL0) REG8(UCB1CTL1) REG8(UCB1IE) REG8(UCB1RXBUF)
+REG8(PMMCTL0_H) REG8(PMMCTL0_L)
+REG16(PMMIFG) REG16(SVSMHCTL) REG16(SVSMLCTL)
+REG16(UCSCTL0) REG16(UCSCTL1) REG16(UCSCTL2) REG16(UCSCTL3) REG16(UCSCTL4) REG16(UCSCTL7)
+REG16(SFRIFG1)
+
+#define BIT1 0x0002
+#define BIT2 0x0004
+#define BIT3 0x0008
+
+#define WDTPW 0x5A00
+#define WDTHOLD 0x0080
+#define GIE 0x0008
+#define LPM0_bits 0x0010
+#define SCG0 0x0040
+
+#define TACLR 0x0004
+#define MC_0 0x0000
+#define MC_1 0x0010
+#define MC_2 0x0020
+#define MC_3 0x0030
+#define ID_1 0x0040
+#define TASSEL_1 0x0100
+#define TASSEL_2 0x0200
+#define CCIE 0x0010
+#define OUTMOD_7 0x00E0
+
+#define DMA0TSEL_5 5
+#define DMADT_0 0x0000
+#define DMASRCINCR_3 0x0300
+#define DMADSTINCR_0 0x0000
+#define DMASRCBYTE 0x0040
+#define DMAIE 0x0004
+#define DMAIFG 0x0008
+#define DMAEN 0x0010
+
+#define UCSWRST 0x01
+#define UCSYNC 0x01
+#define UCMSB 0x20
+#define UCCKPH 0x80
+#define UCRXIE 0x01
+
+// Power and clock setup: the emulator runs at AUDIO_MCLK_HZ from the start
+#define PMMPW_H 0xA5
+#define PMMCOREV0 0x0001
+#define SVSHE 0x0400
+#define SVSHRVL0 0x0100
+#define SVMHE 0x4000
+#define SVSMHRRL0 0x0001
+#define SVSLE 0x0400
+#define SVSLRVL0 0x0100
+#define SVMLE 0x4000
+#define SVSMLRRL0 0x0001
+#define SVSMLDLYIFG 0x0001
+#define SVMLIFG 0x0002
+#define SVMLVLRIFG 0x0004
+#define SELREF__REFOCLK 0x0020
+#define SELA__REFOCLK 0x0200
+#define SELS__DCOCLKDIV 0x0040
+#define SELM__DCOCLKDIV 0x0004
+#define DCORSEL_6 0x0060
+#define FLLD_1 0x1000
+#define XT2OFFG 0x0008
+#define XT1LFOFFG 0x0002
+#define DCOFFG 0x0001
+#define OFIFG 0x0002
+
+#define __even_in_range(value, range) (value)
+#define __enable_interrupt() (emu_interrupts = 1)
+#define __disable_interrupt() (emu_interrupts = 0)
+#define __delay_cycles(cycles) emu_delay(cycles)
+#define __bis_SR_register(bits) ((void)(bits))
+#define __bic_SR_register(bits) ((void)(bits))
+#define _BIS_SR(bits) ((void)(bits))
+#define __data16_write_addr(reg, address) emu_write_addr((unsigned short)(reg), (address))
+
+void emu_write_addr(unsigned short reg, unsigned long address);
+void emu_delay(unsigned long count); // link bytes arrive meanwhile if interrupts are on
+extern int emu_interrupts;
+
+#endif
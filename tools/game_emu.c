@@ -0,0 +1,1061 @@
+/* game_emu.c
+ * Host harness that runs main.c from a script of knob turns and
+ * button presses, against an emulated LCD bus, ADC, timers, info
+ * flash and back-channel UART. It traces the LCD bus per call site
+ * and per frame, and with two scripts runs two consoles on the link.
+ *
+ *   gcc -O1 -fno-inline -rdynamic -Itools/emu/game -I. -o game_emu tools/game_emu.c
+ *   ./game_emu -f frames.csv game.txt       bus trace of a scripted game
+ *   ./game_emu -l 20 tools/link/left.txt tools/link/right.txt   two linked consoles, 20ms apart
+ *   gcc -DSPI_TRACE ... && ./game_emu -u - tools/golden/capture.txt | ./pbm_compare tools/golden out
+ *
+ *   -u file    write what goes out on the back-channel UART (panel
+ *              dumps, the FRAME_BENCH JSON), - for stdout, which
+ *              sends the report to stderr
+ *   -f file    write the bus totals of every frame as CSV
+ *   -l ms      latency the link adds after a byte's stop bit (two
+ *              scripts only, at least one cycle)
+ *
+ * A script has one event per line, in time order, and # comments:
+ *   <ms> knob <0..63>   what get_adc_position() reads from then on
+ *   <ms> press          the debug button goes down
+ *   <ms> release
+ *   <ms> end            stop and report
+ *
+ * Time is counted in cycles of the 1MHz MCLK, and the game's own code
+ * takes none: time passes in __delay_cycles(), on the LCD bus (what
+ * SPI_BYTE_CYCLES and SPI_CS_CYCLES in main.c give a byte and a
+ * transaction besides their delays), in ADC conversions, flash erases
+ * and writes, and in loops waiting on a flag. TA1R therefore counts
+ * what the FRAME_BENCH build models, not what the board measures. It
+ * doesn't wrap at 16 bits, so differences of it come out right in the
+ * host's wider unsigned int.
+ *
+ * Every byte on the bus is decoded the way the UC1701 takes it and
+ * checked against a copy of the panel RAM. Bytes are put down to the
+ * call site of the function that called spi_IO() or send_byte(): its
+ * name and the return address in its caller, so build with -rdynamic
+ * and without inlining. They are also put down to the frame they went
+ * out in: a frame starts at every knob read of the game loops (main(),
+ * run_link_game(), run_multi_ball()), and a knob read anywhere else
+ * (menus, waits) ends it. Wasted bytes are data the panel already
+ * held, page or column sets to where the panel already was, address
+ * sets replaced before any data used them, and data outside the panel.
+ *
+ * With two scripts the consoles run as two processes whose link UARTs
+ * are wired together through a socket. A console runs ahead only as
+ * far as nothing from the other one can still arrive, so both get the
+ * same bytes at the same cycles on every run. Each console stops when
+ * its linked game is over, and the two should show the same score on
+ * the 7-segment display; the exit status is 1 if they don't, or if
+ * either didn't finish a linked game. The title screen gives the ACK
+ * 100ms, so from about 48ms latency on the consoles never link.
+ *
+ * rand() is newlib's for the MSP430 and time(0) is 0, so a script
+ * plays the same game on every run. Info flash starts erased. TELEMETRY
+ * builds are not supported, DMA0 isn't emulated.
+ */
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#ifdef TELEMETRY
+#error "game_emu doesn't emulate DMA0, build without TELEMETRY"
+#endif
+
+#define INFO_FLASH_SIZE 512
+unsigned char info_flash[INFO_FLASH_SIZE];
+#define INFO_FLASH info_flash
+
+/* rand() as newlib has it with a 16 bit int (RAND_MAX 0x7FFF), so
+ * the AIs make the moves they make on the board */
+unsigned long long rand_next = 1;
+
+void emu_srand(unsigned int seed)
+{
+    rand_next = seed & 0xFFFF;
+}
+
+int emu_rand(void)
+{
+    rand_next = rand_next * 6364136223846793005ULL + 1;
+    return (int)((rand_next >> 32) & 0x7FFF);
+}
+
+#define srand(seed) emu_srand(seed)
+#define rand() emu_rand()
+#define time(t) ((time_t)0)
+
+#define main game_main
+#include <main.c>
+#undef main
+
+#define MAX_SECONDS 600 // without an end event
+#define BUS_BYTE_CYCLES 40 // SPI_BYTE_CYCLES less the 16 cycles of __delay_cycles()
+#define BUS_CS_CYCLES 11   // SPI_CS_CYCLES less its __delay_cycles(1)
+#define POLL_CYCLES 4      // one pass of a loop waiting on a flag
+#define ADC_CYCLES 30      // get_adc_position(): about 6us to sample and convert, and the call
+#define FLASH_ERASE_CYCLES 25000 // a segment erase holds the CPU for about 25ms
+#define FLASH_BYTE_CYCLES 75
+#define ACLK_HZ 32768
+#define MAX_EVENTS 1024
+#define MAX_SITES 512
+#define SYMBOLS 4096 // power of 2
+#define STACK_DEPTH 32
+#define RX_QUEUE 4096 // power of 2
+#define NO_WRITE 0xFFFF // in a TXBUF until the game writes a byte
+
+typedef unsigned long long cycles;
+
+/* Script */
+
+#define EVENT_KNOB 0
+#define EVENT_PRESS 1
+#define EVENT_RELEASE 2
+#define EVENT_END 3
+
+struct event
+{
+    cycles at;
+    int kind;
+    int knob;
+} events[MAX_EVENTS];
+int event_count = 0;
+int next_event = 0;
+int knob = 32;
+int button = 0;
+cycles end_at = (cycles)MAX_SECONDS * MCLK_HZ;
+
+/* Bus trace */
+
+#define WASTE_SAME_DATA 0
+#define WASTE_SAME_ADDRESS 1
+#define WASTE_UNUSED_ADDRESS 2
+#define WASTE_OUTSIDE 3
+#define WASTES 4
+
+const char *const waste_names[WASTES] = {"same_data", "same_address", "unused_address", "outside"};
+
+struct totals
+{
+    unsigned long transactions;
+    unsigned long commands;
+    unsigned long data;
+    unsigned long waste[WASTES];
+};
+
+struct site
+{
+    void *function; // start of the function that called spi_IO() or send_byte()
+    void *call;     // return address in its caller
+    struct totals totals;
+} sites[MAX_SITES];
+int site_count = 0;
+
+struct frame
+{
+    cycles start;
+    struct totals totals;
+} *frames_seen;
+long frame_count = 0;
+long frame_capacity = 0;
+long frame_now = -1;       // index in frames_seen, -1 outside the game loops
+struct totals idle_totals; // outside the game loops
+
+struct symbol
+{
+    void *pc;
+    void *start;
+    const char *name;
+} symbols[SYMBOLS];
+int symbol_count = 0;
+
+unsigned int bus_p3;   // P3OUT as last seen
+int bus_selected = 0;  // CS is low
+int bus_first = 0;     // no byte yet in this transaction
+int bus_bits = 0;
+unsigned char bus_shift = 0;
+int bus_parameter = 0; // the next command byte belongs to the last one
+int lcd_page = 0;
+int lcd_column = 0;
+unsigned char lcd_ram[8][102];
+unsigned char lcd_known[8][102];
+
+// The last page, column LSB and column MSB set, until data uses them
+struct address_set
+{
+    struct site *site;
+    long frame;
+} address_sets[3];
+
+/* Emulated hardware */
+
+volatile unsigned int regs[EMU_REGS];
+int emu_interrupts = 0;
+int in_interrupt = 0;
+cycles now = 0;
+cycles ta0_start = 0;
+unsigned long ta0_ticks = 0;
+cycles ta1_start = 0;
+cycles tx_free = 0; // UCA1TXBUF empties (its byte goes to the shift register)
+cycles tx_done = 0; // the last byte's stop bit is out
+cycles audio_done = 0;
+unsigned long audio_frames = 0;
+unsigned long serial_bytes = 0;
+unsigned long serial_received = 0;
+unsigned char flash_shadow[INFO_FLASH_SIZE]; // info flash at the last FCTL1 access
+FILE *serial_out = 0;
+FILE *report = 0;
+const char *frames_file = 0;
+
+/* The link */
+
+struct message
+{
+    cycles at;
+    int byte; // -1: nothing else from the sender arrives before at
+};
+
+struct message rx_queue[RX_QUEUE];
+unsigned int rx_head = 0, rx_tail = 0;
+int console = -1; // with two scripts, 0 or 1
+int peer = -1;    // socket to the other console
+int results = -1; // pipe for console 1's score
+int linked = 0;    // 1 during a linked game, 2 after it
+cycles latency = 1;
+cycles rx_known = ~0ULL; // every byte arriving before this is in rx_queue
+cycles promised = 0;     // sent to the other console as its rx_known
+
+void advance(cycles count);
+
+void read_script(const char *file)
+{
+    FILE *f = fopen(file, "r");
+    char line[128], kind[16];
+    double ms;
+    int value, fields;
+
+    if (!f)
+    {
+        perror(file);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), f))
+    {
+        struct event *event = &events[event_count];
+        if ((fields = sscanf(line, "%lf %15s %d", &ms, kind, &value)) < 2 || line[0] == '#')
+        {
+            continue;
+        }
+        event->at = (cycles)(ms * MCLK_HZ / 1000);
+        event->knob = value;
+        if (strcmp(kind, "knob") == 0 && fields == 3 && value >= 0 && value < 64)
+            event->kind = EVENT_KNOB;
+        else if (strcmp(kind, "press") == 0)
+            event->kind = EVENT_PRESS;
+        else if (strcmp(kind, "release") == 0)
+            event->kind = EVENT_RELEASE;
+        else if (strcmp(kind, "end") == 0)
+            event->kind = EVENT_END;
+        else
+        {
+            fprintf(stderr, "%s: can't read %s", file, line);
+            exit(1);
+        }
+        if (event_count > 0 && event->at < events[event_count - 1].at)
+        {
+            fprintf(stderr, "%s: events out of order at %s", file, line);
+            exit(1);
+        }
+        if (event->kind == EVENT_END)
+        {
+            end_at = event->at;
+        }
+        if (++event_count == MAX_EVENTS)
+        {
+            break;
+        }
+    }
+    fclose(f);
+}
+
+void apply_script(void)
+{
+    while (next_event < event_count && events[next_event].at <= now)
+    {
+        struct event *event = &events[next_event++];
+        if (event->kind == EVENT_KNOB)
+            knob = event->knob;
+        else if (event->kind == EVENT_PRESS)
+            button = 1;
+        else if (event->kind == EVENT_RELEASE)
+            button = 0;
+    }
+}
+
+/* Call sites */
+
+/* Name and start of the function pc is in, looked up once */
+struct symbol *symbol_at(void *pc)
+{
+    static struct symbol unknown = {0, 0, "?"};
+    unsigned int i = ((unsigned long)pc >> 2) & (SYMBOLS - 1);
+    Dl_info info;
+
+    while (symbols[i].pc != 0 && symbols[i].pc != pc)
+    {
+        i = (i + 1) & (SYMBOLS - 1);
+    }
+    if (symbols[i].pc == 0)
+    {
+        if (symbol_count > SYMBOLS / 2)
+        {
+            return &unknown;
+        }
+        symbol_count++;
+        symbols[i].pc = pc;
+        symbols[i].start = pc;
+        symbols[i].name = "?";
+        if (dladdr(pc, &info) && info.dli_sname)
+        {
+            symbols[i].start = info.dli_saddr;
+            symbols[i].name = info.dli_sname;
+        }
+    }
+    return &symbols[i];
+}
+
+/* Index of the first frame on the stack in function name, or -1 */
+int find_function(void **stack, int depth, const char *name)
+{
+    int i;
+    for (i = 0; i < depth; i++)
+    {
+        if (strcmp(symbol_at(stack[i])->name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* The call site the byte on its way to the panel came from */
+struct site *find_site(void)
+{
+    void *stack[STACK_DEPTH];
+    int depth = backtrace(stack, STACK_DEPTH);
+    int bus = find_function(stack, depth, "spi_IO");
+    void *function = 0, *call = 0;
+    int i;
+
+    if (bus < 0)
+    {
+        bus = find_function(stack, depth, "send_byte");
+    }
+    if (bus >= 0 && bus + 2 < depth)
+    {
+        function = symbol_at(stack[bus + 1])->start;
+        call = stack[bus + 2];
+    }
+    for (i = 0; i < site_count; i++)
+    {
+        if (sites[i].function == function && sites[i].call == call)
+        {
+            return &sites[i];
+        }
+    }
+    if (site_count == MAX_SITES)
+    {
+        return &sites[MAX_SITES - 1];
+    }
+    sites[site_count].function = function;
+    sites[site_count].call = call;
+    return &sites[site_count++];
+}
+
+void finish(void);
+
+/* A knob read: starts a frame if a game loop made it. With two
+ * scripts, the first one after a linked game ends the run. */
+void knob_read(void)
+{
+    const char *const loops[] = {"game_main", "run_link_game", "run_multi_ball"};
+    void *stack[STACK_DEPTH];
+    int depth = backtrace(stack, STACK_DEPTH);
+    int read = find_function(stack, depth, "get_adc_position");
+    int i;
+
+    frame_now = -1;
+    if (read < 0 || read + 1 >= depth)
+    {
+        return;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        if (strcmp(symbol_at(stack[read + 1])->name, loops[i]) == 0)
+        {
+            if (i == 1)
+            {
+                linked = 1;
+            }
+            if (frame_count == frame_capacity)
+            {
+                frame_capacity = frame_capacity ? 2 * frame_capacity : 1024;
+                frames_seen = realloc(frames_seen, frame_capacity * sizeof(struct frame));
+            }
+            memset(&frames_seen[frame_count], 0, sizeof(struct frame));
+            frames_seen[frame_count].start = now;
+            frame_now = frame_count++;
+            return;
+        }
+    }
+    if (linked && console >= 0)
+    {
+        linked = 2;
+        finish(); // the linked game is over, its score is on the display
+    }
+}
+
+/* LCD bus */
+
+struct totals *frame_totals(long frame)
+{
+    return frame < 0 ? &idle_totals : &frames_seen[frame].totals;
+}
+
+void waste(struct site *site, long frame, int kind)
+{
+    site->totals.waste[kind]++;
+    frame_totals(frame)->waste[kind]++;
+}
+
+/* A page (kind 0) or column (1, 2) set */
+void set_address(struct site *site, int kind, int page, int column)
+{
+    struct address_set *last = &address_sets[kind];
+
+    if (page == lcd_page && column == lcd_column)
+    {
+        waste(site, frame_now, WASTE_SAME_ADDRESS);
+        return;
+    }
+    if (last->site != 0)
+    {
+        waste(last->site, last->frame, WASTE_UNUSED_ADDRESS);
+    }
+    last->site = site;
+    last->frame = frame_now;
+    lcd_page = page;
+    lcd_column = column;
+}
+
+void bus_byte(unsigned char byte, int data)
+{
+    struct site *site = find_site();
+    struct totals *frame = frame_totals(frame_now);
+
+    advance(BUS_BYTE_CYCLES);
+    if (bus_first)
+    {
+        bus_first = 0;
+        site->totals.transactions++;
+        frame->transactions++;
+    }
+    if (!data)
+    {
+        site->totals.commands++;
+        frame->commands++;
+        if (bus_parameter)
+            bus_parameter = 0;
+        else if (byte == 0x81 || byte == 0xF8 || byte == 0xFA) // contrast, booster, advanced control
+            bus_parameter = 1;
+        else if ((byte & 0xF0) == 0xB0)
+            set_address(site, 0, byte & 0x0F, lcd_column);
+        else if ((byte & 0xF0) == 0x00)
+            set_address(site, 1, lcd_page, (lcd_column & 0xF0) | (byte & 0x0F));
+        else if ((byte & 0xF0) == 0x10)
+            set_address(site, 2, lcd_page, (lcd_column & 0x0F) | ((byte & 0x0F) << 4));
+        return;
+    }
+
+    site->totals.data++;
+    frame->data++;
+    memset(address_sets, 0, sizeof(address_sets));
+    if (lcd_page >= 8 || lcd_column >= 102)
+    {
+        waste(site, frame_now, WASTE_OUTSIDE);
+    }
+    else
+    {
+        if (lcd_known[lcd_page][lcd_column] && lcd_ram[lcd_page][lcd_column] == byte)
+        {
+            waste(site, frame_now, WASTE_SAME_DATA);
+        }
+        lcd_ram[lcd_page][lcd_column] = byte;
+        lcd_known[lcd_page][lcd_column] = 1;
+    }
+    lcd_column++;
+}
+
+/* Takes in a change of P3OUT: CS frames a transaction, a byte is
+ * shifted in MSB first on rising edges of SCK, CD tells commands
+ * from data */
+void bus_update(unsigned int p3)
+{
+    unsigned int changed = p3 ^ bus_p3;
+
+    bus_p3 = p3;
+    if (!(P3DIR & CS))
+    {
+        return;
+    }
+    if ((changed & CS) && !(p3 & CS))
+    {
+        bus_selected = 1;
+        bus_first = 1;
+        bus_bits = 0;
+    }
+    if ((changed & SCK) && (p3 & SCK) && bus_selected)
+    {
+        bus_shift = (bus_shift << 1) | (p3 & MOSI ? 1 : 0);
+        if (++bus_bits == 8)
+        {
+            bus_bits = 0;
+            bus_byte(bus_shift, p3 & CD);
+        }
+    }
+    if ((changed & CS) && (p3 & CS) && bus_selected)
+    {
+        bus_selected = 0;
+        advance(BUS_CS_CYCLES);
+    }
+}
+
+/* Timers, UART and the link */
+
+cycles uart_byte_cycles(void)
+{
+    unsigned int divider = UCA1BR0 + 256 * UCA1BR1;
+    return 10 * (cycles)(divider ? divider : 104); // start, 8 data and stop bit
+}
+
+void send_message(cycles at, int byte)
+{
+    struct message message;
+
+    message.at = at;
+    message.byte = byte;
+    if (send(peer, &message, sizeof(message), MSG_NOSIGNAL) != sizeof(message) && errno != EPIPE)
+    {
+        perror("link");
+        exit(1);
+    }
+}
+
+/* Waits for the other console's next message */
+void receive_message(void)
+{
+    struct message message;
+    cycles promise = now + uart_byte_cycles() + latency;
+    size_t got = 0;
+    ssize_t n;
+
+    if (promise > promised)
+    {
+        send_message(promise, -1);
+        promised = promise;
+    }
+    while (got < sizeof(message))
+    {
+        n = read(peer, (char *)&message + got, sizeof(message) - got);
+        if (n <= 0)
+        {
+            fprintf(stderr, "console %d: the other console went away\n", console);
+            exit(1);
+        }
+        got += n;
+    }
+    if (message.byte >= 0)
+    {
+        rx_queue[rx_tail++ & (RX_QUEUE - 1)] = message;
+    }
+    if (message.at > rx_known)
+    {
+        rx_known = message.at;
+    }
+}
+
+void uart_write(unsigned int byte)
+{
+    cycles start = now > tx_done ? now : tx_done;
+
+    tx_free = start;
+    tx_done = start + uart_byte_cycles();
+    serial_bytes++;
+    if (serial_out)
+    {
+        fputc(byte, serial_out);
+    }
+    if (peer >= 0)
+    {
+        send_message(tx_done + latency, byte);
+    }
+}
+
+int ta0_running(void)
+{
+    return (TA0CTL & MC_3) && (TA0CCTL0 & CCIE);
+}
+
+cycles ta0_next(void)
+{
+    return ta0_start + (cycles)(ta0_ticks + 1) * ((TA0CCR0 & 0xFFFF) + 1) * MCLK_HZ / ACLK_HZ;
+}
+
+/* Runs time on by count cycles, with the interrupts that come due */
+void advance(cycles count)
+{
+    cycles end = now + count;
+
+    while (now < end)
+    {
+        cycles next = end;
+        int timer = ta0_running() && emu_interrupts && !in_interrupt;
+        int rx = rx_head != rx_tail && emu_interrupts && !in_interrupt;
+
+        if (end_at < next)
+            next = end_at;
+        if (timer && ta0_next() < next)
+            next = ta0_next() > now ? ta0_next() : now;
+        if (rx && rx_queue[rx_head & (RX_QUEUE - 1)].at < next)
+            next = rx_queue[rx_head & (RX_QUEUE - 1)].at > now ? rx_queue[rx_head & (RX_QUEUE - 1)].at : now;
+        if (peer >= 0 && rx_known <= next)
+        {
+            // Run up to what's known of the other console, then wait for more
+            if (rx_known > now + 1)
+            {
+                next = rx_known - 1;
+            }
+            else
+            {
+                receive_message();
+                continue;
+            }
+        }
+        now = next;
+        if (now >= end_at)
+        {
+            finish();
+        }
+
+        in_interrupt = 1;
+        if (rx && rx_queue[rx_head & (RX_QUEUE - 1)].at <= now)
+        {
+            struct message *message = &rx_queue[rx_head++ & (RX_QUEUE - 1)];
+            if (UCA1IE & UCRXIE)
+            {
+                UCA1RXBUF = message->byte;
+                regs[EMU_UCA1IFG] |= UCRXIFG;
+                USCI_A1_ISR();
+                regs[EMU_UCA1IFG] &= ~UCRXIFG;
+                serial_received++;
+            }
+        }
+        else if (timer && ta0_next() <= now)
+        {
+            while (ta0_next() <= now)
+            {
+                ta0_ticks++;
+            }
+            TIMER0_A0_ISR();
+        }
+        in_interrupt = 0;
+    }
+}
+
+/* Erases and writes done since the last FCTL1 access. An erase
+ * shows up as the segment the dummy write changed. */
+void flash_update(unsigned int mode)
+{
+    int i, changed = 0;
+
+    for (i = 0; i < INFO_FLASH_SIZE; i++)
+    {
+        if (info_flash[i] != flash_shadow[i])
+        {
+            if (mode & ERASE)
+            {
+                memset(&info_flash[i & ~127], 0xFF, 128);
+                advance(FLASH_ERASE_CYCLES);
+                break;
+            }
+            changed++;
+        }
+    }
+    advance((cycles)changed * FLASH_BYTE_CYCLES);
+    memcpy(flash_shadow, info_flash, INFO_FLASH_SIZE);
+}
+
+/* Picks up what the game wrote since the last access */
+void emu_sync(void)
+{
+    if ((regs[EMU_P3OUT] & 0xFF) != bus_p3)
+    {
+        bus_update(regs[EMU_P3OUT] & 0xFF);
+    }
+    if (regs[EMU_UCA1TXBUF] != NO_WRITE)
+    {
+        uart_write(regs[EMU_UCA1TXBUF] & 0xFF);
+        regs[EMU_UCA1TXBUF] = NO_WRITE;
+    }
+    if (regs[EMU_UCB1TXBUF] != NO_WRITE)
+    {
+        // DMA1 sends the rest of the frame, a byte per 8 bit clocks
+        audio_done = now + (cycles)((DMA1SZ & 0xFFFF) + 1) * 8 * AUDIO_LINK_DIVIDER;
+        audio_frames++;
+        regs[EMU_UCB1TXBUF] = NO_WRITE;
+    }
+    if (TA0CTL & TACLR)
+    {
+        TA0CTL &= ~TACLR;
+        ta0_start = now;
+        ta0_ticks = 0;
+    }
+    if (TA1CTL & TACLR)
+    {
+        TA1CTL &= ~TACLR;
+        ta1_start = now;
+    }
+}
+
+volatile unsigned int *emu_reg(int reg)
+{
+    volatile unsigned int *value = &regs[reg];
+
+    if (in_interrupt)
+    {
+        return value;
+    }
+    emu_sync();
+    switch (reg)
+    {
+    case EMU_P2IN:
+        apply_script();
+        *value = button ? 0xFF & ~BIT1 : 0xFF;
+        break;
+    case EMU_TA1R:
+        advance(POLL_CYCLES);
+        *value = (TA1CTL & MC_3) ? (unsigned int)((now - ta1_start) >> ((TA1CTL & ID_3) >> 6)) : 0;
+        break;
+    case EMU_ADC12CTL1:
+        if (ADC12CTL0 & ADC12SC)
+        {
+            ADC12CTL0 &= ~ADC12SC;
+            advance(ADC_CYCLES);
+            apply_script();
+            ADC12MEM0 = knob << 6 | 0x20;
+            knob_read();
+        }
+        *value &= ~ADC12BUSY;
+        break;
+    case EMU_UCA1IFG:
+        advance(POLL_CYCLES);
+        *value = (*value & ~UCTXIFG) | (now >= tx_free ? UCTXIFG : 0);
+        break;
+    case EMU_DMA1CTL:
+        advance(POLL_CYCLES);
+        if (now >= audio_done)
+        {
+            *value &= ~DMAEN;
+        }
+        break;
+    case EMU_FCTL1:
+        flash_update(*value);
+        break;
+    }
+    return value;
+}
+
+void emu_delay(unsigned long count)
+{
+    emu_sync();
+    advance(count);
+}
+
+/* Report */
+
+void print_totals(const char *name, const struct totals *totals)
+{
+    int i;
+
+    fprintf(report, "%-40s %8lu %8lu %8lu", name, totals->transactions, totals->commands, totals->data);
+    for (i = 0; i < WASTES; i++)
+    {
+        fprintf(report, " %14lu", totals->waste[i]);
+    }
+    fprintf(report, "\n");
+}
+
+unsigned long wasted(const struct totals *totals)
+{
+    return totals->waste[0] + totals->waste[1] + totals->waste[2] + totals->waste[3];
+}
+
+int by_waste(const void *a, const void *b)
+{
+    const struct totals *x = &((const struct site *)a)->totals, *y = &((const struct site *)b)->totals;
+    unsigned long wx = wasted(x), wy = wasted(y);
+
+    if (wx != wy)
+        return wx < wy ? 1 : -1;
+    if (x->commands + x->data != y->commands + y->data)
+        return x->commands + x->data < y->commands + y->data ? 1 : -1;
+    return 0;
+}
+
+void print_report(void)
+{
+    struct totals all = {0};
+    long worst_bytes = -1, worst_waste = -1, f;
+    char name[96];
+    int i, k;
+
+    for (i = 0; i < site_count; i++)
+    {
+        all.transactions += sites[i].totals.transactions;
+        all.commands += sites[i].totals.commands;
+        all.data += sites[i].totals.data;
+        for (k = 0; k < WASTES; k++)
+        {
+            all.waste[k] += sites[i].totals.waste[k];
+        }
+    }
+
+    fprintf(report, "%.1f s, %lu LCD bytes in %lu transactions, %lu wasted; %lu UART bytes, %lu audio frames\n\n",
+            (double)now / MCLK_HZ, all.commands + all.data, all.transactions, wasted(&all), serial_bytes, audio_frames);
+    fprintf(report, "%-40s %8s %8s %8s", "call site", "trans", "commands", "data");
+    for (k = 0; k < WASTES; k++)
+    {
+        fprintf(report, " %14s", waste_names[k]);
+    }
+    fprintf(report, "\n");
+    qsort(sites, site_count, sizeof(struct site), by_waste);
+    for (i = 0; i < site_count; i++)
+    {
+        struct symbol *function = symbol_at(sites[i].function);
+        struct symbol *caller = symbol_at(sites[i].call);
+        snprintf(name, sizeof(name), "%s < %s+0x%lx", function->name, caller->name,
+                 (unsigned long)((char *)sites[i].call - (char *)caller->start));
+        print_totals(sites[i].function ? name : "?", &sites[i].totals);
+    }
+    print_totals("total", &all);
+
+    for (f = 0; f < frame_count; f++)
+    {
+        const struct totals *t = &frames_seen[f].totals;
+        if (worst_bytes < 0 || t->commands + t->data > frames_seen[worst_bytes].totals.commands + frames_seen[worst_bytes].totals.data)
+            worst_bytes = f;
+        if (worst_waste < 0 || wasted(t) > wasted(&frames_seen[worst_waste].totals))
+            worst_waste = f;
+    }
+    fprintf(report, "\n%ld game loop frames", frame_count);
+    if (frame_count > 0)
+    {
+        const struct totals *b = &frames_seen[worst_bytes].totals;
+        fprintf(report, ", %.1f bytes and %.1f wasted a frame\n", (double)(all.commands + all.data - idle_totals.commands - idle_totals.data) / frame_count,
+                (double)(wasted(&all) - wasted(&idle_totals)) / frame_count);
+        fprintf(report, "most bytes: frame %ld at %.0f ms, %lu bytes, %lu wasted\n", worst_bytes,
+                (double)frames_seen[worst_bytes].start * 1000 / MCLK_HZ, b->commands + b->data, wasted(b));
+        b = &frames_seen[worst_waste].totals;
+        fprintf(report, "most wasted: frame %ld at %.0f ms, %lu bytes, %lu wasted\n", worst_waste,
+                (double)frames_seen[worst_waste].start * 1000 / MCLK_HZ, b->commands + b->data, wasted(b));
+    }
+    else
+    {
+        fprintf(report, "\n");
+    }
+    fprintf(report, "outside the game loops: %lu bytes, %lu wasted\n", idle_totals.commands + idle_totals.data, wasted(&idle_totals));
+}
+
+void write_frames(void)
+{
+    FILE *f = fopen(frames_file, "w");
+    long i;
+    int k;
+
+    if (!f)
+    {
+        perror(frames_file);
+        return;
+    }
+    fprintf(f, "frame,ms,transactions,commands,data");
+    for (k = 0; k < WASTES; k++)
+    {
+        fprintf(f, ",%s", waste_names[k]);
+    }
+    fprintf(f, "\n");
+    for (i = 0; i < frame_count; i++)
+    {
+        const struct totals *t = &frames_seen[i].totals;
+        fprintf(f, "%ld,%.2f,%lu,%lu,%lu", i, (double)frames_seen[i].start * 1000 / MCLK_HZ, t->transactions, t->commands, t->data);
+        for (k = 0; k < WASTES; k++)
+        {
+            fprintf(f, ",%lu", t->waste[k]);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+}
+
+/* The score on the 7-segment display, player * 100 + computer */
+int shown_score(void)
+{
+    return ((display_digits[3] & 0x0F) * 10 + (display_digits[2] & 0x0F)) * 100 +
+           (display_digits[1] & 0x0F) * 10 + (display_digits[0] & 0x0F);
+}
+
+void print_console(int score)
+{
+    fprintf(report, "console %d: %.1f s, %ld frames, %lu link bytes sent, %lu received, ", console, (double)now / MCLK_HZ,
+            frame_count, serial_bytes, serial_received);
+    if (score < 0)
+    {
+        fprintf(report, linked ? "the linked game didn't end\n" : "no linked game\n");
+    }
+    else
+    {
+        fprintf(report, "score %d-%d\n", score / 100, score % 100);
+    }
+}
+
+/* The script or the linked game has ended: report and exit */
+void finish(void)
+{
+    int score = linked == 2 ? shown_score() : -1, other;
+
+    if (serial_out)
+    {
+        fflush(serial_out);
+    }
+    if (frames_file)
+    {
+        write_frames();
+    }
+    if (console < 0)
+    {
+        print_report();
+        exit(0);
+    }
+
+    send_message(~0ULL, -1); // the other console needn't wait for this one
+    close(peer);
+    if (console == 1)
+    {
+        print_console(score);
+        fflush(report);
+        if (write(results, &score, sizeof(score)) != sizeof(score))
+        {
+            exit(1);
+        }
+        exit(0);
+    }
+    if (read(results, &other, sizeof(other)) != sizeof(other))
+    {
+        fprintf(stderr, "console 1 gave no score\n");
+        exit(1);
+    }
+    wait(0);
+    print_console(score);
+    if (score < 0 || other < 0)
+    {
+        fprintf(report, "the consoles didn't both finish a linked game\n");
+        exit(1);
+    }
+    if (other != score)
+    {
+        fprintf(report, "the consoles disagree on the score\n");
+        exit(1);
+    }
+    exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *scripts[2];
+    int script_count = 0, i;
+    int sockets[2], pipes[2];
+
+    report = stdout;
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
+        {
+            i++;
+            serial_out = strcmp(argv[i], "-") == 0 ? stdout : fopen(argv[i], "wb");
+            if (!serial_out)
+            {
+                perror(argv[i]);
+                return 1;
+            }
+            if (serial_out == stdout)
+            {
+                report = stderr;
+            }
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+            frames_file = argv[++i];
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+            latency = (cycles)(atof(argv[++i]) * MCLK_HZ / 1000);
+        else if (argv[i][0] != '-' && script_count < 2)
+            scripts[script_count++] = argv[i];
+        else
+            script_count = 3;
+    }
+    if (script_count == 0 || script_count > 2)
+    {
+        fprintf(stderr, "usage: %s [-u uart_out] [-f frames.csv] [-l latency_ms] script [script]\n", argv[0]);
+        return 1;
+    }
+    if (script_count == 2 && (serial_out || frames_file))
+    {
+        fprintf(stderr, "with two scripts the UART is the link, -u and -f are for one console\n");
+        return 1;
+    }
+    if (latency < 1)
+    {
+        latency = 1;
+    }
+
+    if (script_count == 2)
+    {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0 || pipe(pipes) != 0)
+        {
+            perror("link");
+            return 1;
+        }
+        fflush(stdout);
+        console = fork() == 0;
+        peer = sockets[console];
+        close(sockets[!console]);
+        results = pipes[console]; // console 1 writes, console 0 reads
+        close(pipes[!console]);
+        rx_known = 0;
+    }
+    read_script(scripts[console > 0]);
+
+    memset(info_flash, 0xFF, INFO_FLASH_SIZE);
+    memcpy(flash_shadow, info_flash, INFO_FLASH_SIZE);
+    regs[EMU_UCA1TXBUF] = NO_WRITE;
+    regs[EMU_UCB1TXBUF] = NO_WRITE;
+    UCB1IFG = UCTXIFG; // audio frames are timed with DMA1CTL
+    game_main();
+    return 0;
+}
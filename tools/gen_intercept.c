@@ -0,0 +1,264 @@
+/* gen_intercept.c
+ * Host tool that generates intercept_table.h, the flash tables the AI
+ * uses to look up where the ball will cross a paddle's column.
+ *
+ *   gcc -o gen_intercept tools/gen_intercept.c
+ *   ./gen_intercept > intercept_table.h
+ *
+ * Every path is produced by stepping the same rule as move_ball() in
+ * main.c, so the table is exact (including the frames where the ball
+ * is drawn past the walls). Check the output with verify_intercept.c.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPAN 59         // move_ball() bounces when y <= 0 or y >= 59
+#define MAX_Y_SPEED 6   // |y_vel| after a corner hit plus a speed up
+#define MAX_X_SPEED 5   // set_ball_speed() stops at 5
+#define MAX_DIST 64     // from the serve or a return to the far hit zone
+#define MAX_FRAMES MAX_DIST
+#define SEED_Y_MIN -5   // ball y values check_collision() can hit at
+#define SEED_Y_MAX 64
+#define MAX_PATH 8192
+#define INTERCEPT_TWO_CYCLE 0x8000
+
+int y_min = SEED_Y_MIN;
+int y_max = SEED_Y_MAX;
+
+signed char path[MAX_PATH];
+int path_len = 0;
+int start[MAX_Y_SPEED][256];
+
+#define Y_OFFSET 64
+#define Y_GRID 256
+char reachable[2 * MAX_Y_SPEED + 1][Y_GRID];
+
+/* Same step as move_ball() in main.c, on y only */
+void step(int *y, int *v)
+{
+    if (*y <= 0 || *y >= SPAN)
+    {
+        *v = -*v;
+    }
+    *y += *v;
+}
+
+/* Marks every state reachable from a hit or a serve and sets
+ * [y_min, y_max] to the y values those states cover */
+void find_reachable(void)
+{
+    int changed = 1;
+    int y, v;
+    for (v = -MAX_Y_SPEED; v <= MAX_Y_SPEED; v++)
+    {
+        for (y = SEED_Y_MIN; y <= SEED_Y_MAX; y++)
+        {
+            reachable[v + MAX_Y_SPEED][y + Y_OFFSET] = 1;
+        }
+    }
+    while (changed)
+    {
+        changed = 0;
+        for (v = -MAX_Y_SPEED; v <= MAX_Y_SPEED; v++)
+        {
+            for (y = -Y_OFFSET; y < Y_GRID - Y_OFFSET; y++)
+            {
+                int ny = y, nv = v;
+                if (!reachable[v + MAX_Y_SPEED][y + Y_OFFSET])
+                {
+                    continue;
+                }
+                step(&ny, &nv);
+                if (!reachable[nv + MAX_Y_SPEED][ny + Y_OFFSET])
+                {
+                    reachable[nv + MAX_Y_SPEED][ny + Y_OFFSET] = 1;
+                    changed = 1;
+                }
+                if (ny < y_min)
+                    y_min = ny;
+                if (ny > y_max)
+                    y_max = ny;
+            }
+        }
+    }
+}
+
+/* Returns the cycle length if (y, v) comes back to itself, 0 otherwise */
+int cycle_length(int y, int v)
+{
+    int cy = y, cv = v, n;
+    int limit = 2 * (y_max - y_min + 1) * (2 * MAX_Y_SPEED + 1);
+    for (n = 1; n <= limit; n++)
+    {
+        step(&cy, &cv);
+        if (cy == y && cv == v)
+        {
+            return n;
+        }
+    }
+    return 0;
+}
+
+/* Appends the y values visited from (y, v), 'count' entries long */
+int append_path(int y, int v, int count)
+{
+    int offset = path_len, i;
+    if (path_len + count > MAX_PATH)
+    {
+        fprintf(stderr, "path table overflow\n");
+        exit(1);
+    }
+    for (i = 0; i < count; i++)
+    {
+        path[path_len++] = (signed char)y;
+        step(&y, &v);
+    }
+    return offset;
+}
+
+/* Lays out every positive velocity state. States on the same cycle
+ * share one unrolled copy of it, so a lookup is start + frames. */
+void build(void)
+{
+    int v, y, i;
+    for (v = 1; v <= MAX_Y_SPEED; v++)
+    {
+        for (y = y_min; y <= y_max; y++)
+        {
+            start[v - 1][y - y_min] = -1;
+        }
+    }
+    for (v = 1; v <= MAX_Y_SPEED; v++)
+    {
+        for (y = y_min; y <= y_max; y++)
+        {
+            int len, offset, cy = y, cv = v;
+            if (!reachable[v + MAX_Y_SPEED][y + Y_OFFSET])
+            {
+                start[v - 1][y - y_min] = 0; // never looked up
+                continue;
+            }
+            if (start[v - 1][y - y_min] >= 0)
+            {
+                continue;
+            }
+            len = cycle_length(y, v);
+            if (len == 0)
+            {
+                start[v - 1][y - y_min] = append_path(y, v, MAX_FRAMES + 1);
+                continue;
+            }
+            if (len == 2)
+            {
+                // Ball stuck flipping past a wall, store it once and
+                // let the lookup pick the entry from the frame parity
+                offset = append_path(y, v, 2);
+                for (i = 0; i < len; i++)
+                {
+                    if (cv > 0)
+                    {
+                        start[cv - 1][cy - y_min] = (offset + i) | INTERCEPT_TWO_CYCLE;
+                    }
+                    step(&cy, &cv);
+                }
+                continue;
+            }
+            offset = append_path(y, v, len + MAX_FRAMES);
+            for (i = 0; i < len; i++)
+            {
+                if (cv > 0)
+                {
+                    start[cv - 1][cy - y_min] = offset + i;
+                }
+                step(&cy, &cv);
+            }
+        }
+    }
+}
+
+void print_frames(void)
+{
+    int speed, dist;
+    printf("const unsigned char intercept_frames[INTERCEPT_MAX_X_SPEED][INTERCEPT_MAX_DIST + 1] =\n{\n");
+    for (speed = 1; speed <= MAX_X_SPEED; speed++)
+    {
+        printf("  {");
+        for (dist = 0; dist <= MAX_DIST; dist++)
+        {
+            if (dist % 16 == 0)
+                printf("\n   ");
+            printf("%3d,", (dist + speed - 1) / speed);
+        }
+        printf("\n  },\n");
+    }
+    printf("};\n\n");
+}
+
+void print_start(void)
+{
+    int v, y;
+    printf("const unsigned int intercept_start[INTERCEPT_MAX_Y_SPEED][INTERCEPT_Y_COUNT] =\n{\n");
+    for (v = 1; v <= MAX_Y_SPEED; v++)
+    {
+        printf("  {");
+        for (y = y_min; y <= y_max; y++)
+        {
+            if ((y - y_min) % 12 == 0)
+                printf("\n   ");
+            printf("%6u,", (unsigned)start[v - 1][y - y_min]);
+        }
+        printf("\n  },\n");
+    }
+    printf("};\n\n");
+}
+
+void print_path(void)
+{
+    int i;
+    printf("const signed char intercept_path[INTERCEPT_PATH_LEN] =\n{");
+    for (i = 0; i < path_len; i++)
+    {
+        if (i % 16 == 0)
+            printf("\n   ");
+        printf("%3d,", path[i]);
+    }
+    printf("\n};\n");
+}
+
+int main(void)
+{
+    find_reachable();
+    if (y_max - y_min + 1 > 256)
+    {
+        fprintf(stderr, "y range too large\n");
+        return 1;
+    }
+    build();
+
+    printf("/* Generated by tools/gen_intercept.c, do not edit.\n");
+    printf(" *\n");
+    printf(" * intercept_frames[|x_vel| - 1][dist] is the number of move_ball()\n");
+    printf(" * calls before the ball covers dist pixels.\n");
+    printf(" *\n");
+    printf(" * intercept_path[intercept_start[y_vel - 1][y - INTERCEPT_Y_MIN] + frames]\n");
+    printf(" * is the ball's y after that many frames, for y_vel > 0. Negative\n");
+    printf(" * velocities use the mirror image: 59 - lookup(59 - y, -y_vel).\n");
+    printf(" *\n");
+    printf(" * Starts with INTERCEPT_TWO_CYCLE set are balls stuck flipping\n");
+    printf(" * outside a wall; their path has two entries picked by frames & 1.\n");
+    printf(" */\n\n");
+    printf("#define INTERCEPT_SPAN %d\n", SPAN);
+    printf("#define INTERCEPT_Y_MIN %d\n", y_min);
+    printf("#define INTERCEPT_Y_MAX %d\n", y_max);
+    printf("#define INTERCEPT_Y_COUNT %d\n", y_max - y_min + 1);
+    printf("#define INTERCEPT_MAX_Y_SPEED %d\n", MAX_Y_SPEED);
+    printf("#define INTERCEPT_MAX_X_SPEED %d\n", MAX_X_SPEED);
+    printf("#define INTERCEPT_MAX_DIST %d\n", MAX_DIST);
+    printf("#define INTERCEPT_PATH_LEN %d\n", path_len);
+    printf("#define INTERCEPT_TWO_CYCLE 0x%X\n\n", INTERCEPT_TWO_CYCLE);
+    print_frames();
+    print_start();
+    print_path();
+    return 0;
+}
@@ -0,0 +1,2064 @@
+/* msp430_sim.c
+ * Host tool that runs an msp430-gcc ELF of main.c or music.c on a
+ * cycle counting model of the MSP430F5529 (CPUX core) and reports the
+ * cycles spent in every function, so spi_IO, draw_string, the AI movers
+ * and a whole frame can be costed without a board.
+ *
+ *   gcc -O2 -I. -o msp430_sim tools/msp430_sim.c
+ *   msp430-elf-gcc -mmcu=msp430f5529 -O2 -o main.elf main.c
+ *   ./msp430_sim -c 20000000 -k 500000 main.elf
+ *   ./msp430_sim -m 15990784 -t 1000000:2 -t 8000000:1:24 music.elf
+ *   ./msp430_sim -x tools/cycles.txt
+ *
+ *   -c cycles      stop after this many cycles (default 100000000)
+ *   -s sym[:n]     stop the n-th time (default 1st) the PC reaches sym
+ *   -a value       ADC12MEM0 reading, 0..4095 (default 2048)
+ *   -k cycles      turn the knob (flip ADC12MEM0 bit 11) every this many cycles
+ *   -b             hold the debug button (P2.1) down
+ *   -m hz          MCLK, also SMCLK (default 1000000, music.c runs at
+ *                  AUDIO_MCLK_HZ)
+ *   -t cycle:song[:pitch]
+ *                  from cycle, the frame play_music() (or play_effect()
+ *                  with a pitch) sends comes in on USCI_B1 (music.c)
+ *   -u file        write the bytes sent on UCA1TXBUF to file
+ *   -r addr        load a raw binary at addr (hex) instead of an ELF
+ *   -v             trace every instruction to stderr
+ *   -x             the file is a list of hand-encoded instructions with
+ *                  their cycle counts (tools/cycles.txt): run each one and
+ *                  check the cycles charged for it, exit 1 on a mismatch
+ *
+ * Cycle counts follow the CPUX tables of the MSP430x5xx family user's
+ * guide (SLAU208, "Instruction Cycles and Lengths"). Extended (20-bit)
+ * instructions are counted as their base form plus one cycle for the
+ * extension word and one per 20-bit memory access.
+ *
+ * Peripherals the firmware touches are modeled as far as the code needs:
+ * ports P1-P8 (P1/P2 edge interrupts), ADC12 (conversions are instant),
+ * Timer_A0-A2 and Timer_B0 (up and continuous modes, compare flags and
+ * interrupts), the watchdog (timeouts and password resets), the flash
+ * controller, USCI_A1 and USCI_B1 (transmit at the rate UCxxBRW sets,
+ * and the -t frames received on B1), and DMA channels 0-2 in single
+ * transfer mode on the timer and USCI transmit triggers, 2 cycles a
+ * transfer. The core voltage and the FLL settle at once, SMCLK is MCLK
+ * and ACLK 32768Hz. Everything else reads back what was written.
+ *
+ * A function's total counts its callees; calls are seen through CALL,
+ * CALLA and interrupt entry, so tail calls (BR) are charged to the caller.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <audio_link.h>
+
+#define MEM_SIZE 0x100000
+#define ADDR_MASK 0xFFFFF
+#define MAX_SYMBOLS 2048
+#define MAX_TRIGGERS 64
+#define MAX_DEPTH 128
+#define MAX_LINK_BYTES (MAX_TRIGGERS * AUDIO_FRAME_SIZE)
+#define ACLK_HZ 32768
+#define GAME_SMCLK_HZ 1000000ULL // clocks the audio link on the game MCU
+
+#define PC 0
+#define SP 1
+#define SR 2
+#define CG 3
+
+// Status register
+#define SR_C 0x0001
+#define SR_Z 0x0002
+#define SR_N 0x0004
+#define SR_GIE 0x0008
+#define SR_CPUOFF 0x0010
+#define SR_SCG0 0x0040
+#define SR_V 0x0100
+
+// Peripheral registers
+#define PAIN 0x0200
+#define P1IV 0x020E
+#define PAIES 0x0218
+#define PAIE 0x021A
+#define PAIFG 0x021C
+#define P2IV 0x021E
+#define PCIN 0x0240
+#define WDTCTL 0x015C
+#define FCTL1 0x0140
+#define FCTL3 0x0144
+#define FCTL4 0x0146
+#define ADC12CTL0 0x0700
+#define ADC12IFG 0x070A
+#define ADC12MEM0 0x0720
+#define PMMIFG 0x012C
+#define DMACTL0 0x0500 // trigger of channel 0 in the low byte, 1 in the high
+#define DMACTL1 0x0502 // trigger of channel 2
+#define DMAIV 0x050E
+#define DMA0CTL 0x0510 // channel n at DMA0CTL + 0x10 * n
+#define DMA_VECTOR 0xFFE4
+
+// DMAxCTL
+#define DMAREQ 0x0001
+#define DMAIE 0x0004
+#define DMAIFG 0x0008
+#define DMAEN 0x0010
+#define DMASRCBYTE 0x0040
+#define DMADSTBYTE 0x0080
+
+// USCI registers from the module's base
+#define UC_BRW 0x06
+#define UC_STAT 0x0A
+#define UC_RXBUF 0x0C
+#define UC_TXBUF 0x0E
+#define UC_IE 0x1C // UCxxIFG is the high byte
+#define UC_IV 0x1E
+#define UCRXIFG 0x01
+#define UCTXIFG 0x02
+
+struct timer
+{
+    unsigned int base;
+    int ccrs;
+    unsigned int vector_ccr0;
+    unsigned int vector; // other CCRs and overflow
+    unsigned long prescale;
+    int dma_triggers[2]; // of CCR0 and CCR2
+};
+
+struct timer timers[] = {
+    {0x0340, 5, 0xFFEA, 0xFFE8, 0, {1, 2}}, // TA0
+    {0x0380, 3, 0xFFE2, 0xFFE0, 0, {3, 4}}, // TA1
+    {0x0400, 3, 0xFFD8, 0xFFD6, 0, {5, 6}}, // TA2
+    {0x03C0, 7, 0xFFF6, 0xFFF4, 0, {7, 8}}, // TB0
+};
+#define TIMERS ((int)(sizeof(timers) / sizeof(timers[0])))
+
+struct usci
+{
+    unsigned int base;
+    unsigned int vector;
+    int bits;       // a character takes this many times UCxxBRW cycles
+    int tx_trigger; // DMA trigger of UCTXIFG
+    unsigned long long shift_end; // 0 while the shift register is idle
+    unsigned char shift;
+    int buffered; // a byte waits in UCxxTXBUF
+    FILE *out;    // gets every byte sent
+};
+
+struct usci uscis[] = {
+    {0x0600, 0xFFDC, 10, 21, 0, 0, 0, NULL}, // USCI_A1, UART
+    {0x0620, 0xFFDA, 8, 23, 0, 0, 0, NULL},  // USCI_B1, SPI
+};
+#define USCIS ((int)(sizeof(uscis) / sizeof(uscis[0])))
+
+struct dma
+{
+    // Loaded from DMAxSA, DMAxDA and DMAxSZ when DMAEN is set
+    unsigned long source;
+    unsigned long destination;
+    unsigned int size;
+    int requested;
+};
+
+struct dma dmas[3];
+#define DMAS 3
+
+struct symbol
+{
+    char name[40];
+    unsigned long addr;
+    unsigned long size;
+    unsigned long calls;
+    unsigned long long self;
+    unsigned long long total;
+    int active; // instances on the call stack
+};
+
+struct frame
+{
+    int symbol;
+    unsigned long sp; // SP right after the return address was pushed
+    unsigned long long entry;
+};
+
+struct trigger
+{
+    unsigned long long cycle;
+    int song;
+    int pitch;
+};
+
+struct link_byte
+{
+    unsigned long long cycle;
+    unsigned char value;
+};
+
+unsigned char mem[MEM_SIZE];
+unsigned long reg[16];
+unsigned long long cycles = 0;
+unsigned long long instructions = 0;
+unsigned long long sleep_cycles = 0;
+unsigned long long max_cycles = 100000000ULL;
+int resets = 0;
+
+struct symbol symbols[MAX_SYMBOLS];
+int symbol_count = 0;
+struct frame stack[MAX_DEPTH];
+int depth = 0;
+unsigned long long unknown_cycles = 0; // outside every function symbol
+
+struct trigger triggers[MAX_TRIGGERS];
+int trigger_count = 0;
+struct link_byte link_bytes[MAX_LINK_BYTES]; // in order of cycle
+int link_count = 0;
+int link_next = 0;
+
+unsigned long mclk_hz = 1000000;
+unsigned long aclk_divider; // MCLK cycles per ACLK cycle
+unsigned int adc_value = 2048;
+unsigned long long knob_period = 0;
+int button_held = 0;
+unsigned long long wdt_count = 0;
+int trace = 0;
+
+unsigned int peek16(unsigned long addr)
+{
+    addr &= ADDR_MASK & ~1UL;
+    return mem[addr] | (mem[addr + 1] << 8);
+}
+
+void poke16(unsigned long addr, unsigned int value)
+{
+    addr &= ADDR_MASK & ~1UL;
+    mem[addr] = value & 0xFF;
+    mem[addr + 1] = (value >> 8) & 0xFF;
+}
+
+int find_symbol(unsigned long addr)
+{
+    static int last = -1;
+    int low = 0, high = symbol_count - 1;
+
+    if (last >= 0 && addr >= symbols[last].addr && addr < symbols[last].addr + symbols[last].size)
+    {
+        return last;
+    }
+    while (low <= high)
+    {
+        int mid = (low + high) / 2;
+        if (addr < symbols[mid].addr)
+        {
+            high = mid - 1;
+        }
+        else if (addr >= symbols[mid].addr + symbols[mid].size)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            last = mid;
+            return mid;
+        }
+    }
+    return -1;
+}
+
+void push_frame(unsigned long target)
+{
+    int s = find_symbol(target);
+    if (s < 0 || depth == MAX_DEPTH)
+    {
+        return;
+    }
+    symbols[s].calls++;
+    symbols[s].active++;
+    stack[depth].symbol = s;
+    stack[depth].sp = reg[SP];
+    stack[depth].entry = cycles;
+    depth++;
+}
+
+// Closes the frames returned from, sp is SP before the return popped it
+void pop_frames(unsigned long sp)
+{
+    while (depth > 0 && stack[depth - 1].sp <= sp)
+    {
+        struct symbol *s = &symbols[stack[--depth].symbol];
+        if (--s->active == 0)
+        {
+            s->total += cycles - stack[depth].entry;
+        }
+    }
+}
+
+// Power-up clear: the watchdog password resets and timeouts land here
+void puc()
+{
+    int i;
+    for (i = 0; i < TIMERS; i++)
+    {
+        poke16(timers[i].base, 0);
+        timers[i].prescale = 0;
+    }
+    for (i = 0; i < USCIS; i++)
+    {
+        poke16(uscis[i].base + UC_IE, UCTXIFG << 8);
+        uscis[i].shift_end = 0;
+        uscis[i].buffered = 0;
+    }
+    for (i = 0; i < DMAS; i++)
+    {
+        poke16(DMA0CTL + 0x10 * i, 0);
+        dmas[i].requested = 0;
+    }
+    poke16(PAIE, 0);
+    poke16(PAIFG, 0);
+    poke16(WDTCTL, 0x0004);
+    memset(reg, 0, sizeof(reg));
+    reg[PC] = peek16(0xFFFE);
+    wdt_count = 0;
+    pop_frames(ADDR_MASK);
+    resets++;
+}
+
+/* Peripheral side effects */
+
+// A trigger's flag was set: every enabled channel it selects moves a unit
+void dma_trigger(int trigger)
+{
+    int n;
+    for (n = 0; n < DMAS; n++)
+    {
+        if ((peek16(DMA0CTL + 0x10 * n) & DMAEN) && (mem[DMACTL0 + n] & 0x1F) == trigger)
+        {
+            dmas[n].requested = 1;
+        }
+    }
+}
+
+void usci_transmit(struct usci *u, unsigned char value)
+{
+    if (u->shift_end)
+    {
+        u->buffered = 1;
+        mem[u->base + UC_TXBUF] = value;
+        mem[u->base + UC_IE + 1] &= ~UCTXIFG;
+        return;
+    }
+    u->shift = value;
+    u->shift_end = cycles + u->bits * (peek16(u->base + UC_BRW) ? peek16(u->base + UC_BRW) : 1);
+    mem[u->base + UC_IE + 1] |= UCTXIFG; // the buffer is free again at once
+    dma_trigger(u->tx_trigger);
+}
+
+unsigned int usci_iv(struct usci *u)
+{
+    unsigned char pending = mem[u->base + UC_IE] & mem[u->base + UC_IE + 1];
+    if (pending & UCRXIFG)
+    {
+        mem[u->base + UC_IE + 1] &= ~UCRXIFG;
+        return 2;
+    }
+    if (pending & UCTXIFG)
+    {
+        mem[u->base + UC_IE + 1] &= ~UCTXIFG;
+        return 4;
+    }
+    return 0;
+}
+
+unsigned int dma_iv()
+{
+    int n;
+    for (n = 0; n < DMAS; n++)
+    {
+        unsigned int control = peek16(DMA0CTL + 0x10 * n);
+        if (control & DMAIFG)
+        {
+            poke16(DMA0CTL + 0x10 * n, control & ~DMAIFG);
+            return 2 * (n + 1);
+        }
+    }
+    return 0;
+}
+
+void dma_control(int n, unsigned int value)
+{
+    unsigned long base = DMA0CTL + 0x10 * n;
+    int enabled = peek16(base) & DMAEN;
+
+    poke16(base, value & ~DMAREQ);
+    if ((value & DMAEN) && !enabled)
+    {
+        dmas[n].source = peek16(base + 2) | ((unsigned long)(peek16(base + 4) & 0x0F) << 16);
+        dmas[n].destination = peek16(base + 6) | ((unsigned long)(peek16(base + 8) & 0x0F) << 16);
+        dmas[n].size = peek16(base + 0x0A);
+        dmas[n].requested = 0;
+    }
+    if ((value & DMAEN) && (value & DMAREQ))
+    {
+        dmas[n].requested = 1;
+    }
+}
+
+unsigned int timer_iv(struct timer *t)
+{
+    int n;
+    for (n = 1; n < t->ccrs; n++)
+    {
+        unsigned int cctl = peek16(t->base + 2 + 2 * n);
+        if ((cctl & 0x0011) == 0x0011) // CCIE and CCIFG
+        {
+            poke16(t->base + 2 + 2 * n, cctl & ~1);
+            return 2 * n;
+        }
+    }
+    if ((peek16(t->base) & 0x0003) == 0x0003) // TAIE and TAIFG
+    {
+        poke16(t->base, peek16(t->base) & ~1);
+        return 0x0E;
+    }
+    return 0;
+}
+
+unsigned int port_iv(unsigned long ifg)
+{
+    int bit;
+    for (bit = 0; bit < 8; bit++)
+    {
+        if (mem[ifg] & (1 << bit))
+        {
+            mem[ifg] &= ~(1 << bit);
+            return 2 * (bit + 1);
+        }
+    }
+    return 0;
+}
+
+unsigned int io_read(unsigned long addr, int size)
+{
+    unsigned long word = addr & ~1UL;
+    unsigned int value = peek16(word);
+    int i;
+
+    switch (word)
+    {
+    case PAIN:
+        value = mem[0x202];
+        value |= (button_held ? (mem[0x203] & ~0x02) : (mem[0x203] | 0x02)) << 8;
+        break;
+    case PMMIFG:
+        value |= 0x0005; // SVSMLDLYIFG and SVMLVLRIFG, the core is at its level
+        break;
+    case DMAIV:
+        value = dma_iv();
+        break;
+    case P1IV:
+        value = port_iv(PAIFG);
+        break;
+    case P2IV:
+        value = port_iv(PAIFG + 1);
+        break;
+    case WDTCTL:
+        value = 0x6900 | (value & 0xFF);
+        break;
+    case FCTL1:
+    case FCTL3:
+    case FCTL4:
+        value = 0x9600 | (value & 0xFE); // never BUSY
+        break;
+    case ADC12MEM0:
+        mem[ADC12IFG] &= ~1;
+        break;
+    default:
+        for (i = 0; i < TIMERS; i++)
+        {
+            if (word == timers[i].base + 0x2E)
+            {
+                value = timer_iv(&timers[i]);
+            }
+        }
+        for (i = 0; i < USCIS; i++)
+        {
+            if (word == uscis[i].base + UC_STAT)
+            {
+                value = (value & ~1) | (uscis[i].shift_end != 0); // UCBUSY
+            }
+            else if (word == uscis[i].base + UC_RXBUF)
+            {
+                mem[uscis[i].base + UC_IE + 1] &= ~UCRXIFG;
+            }
+            else if (word == uscis[i].base + UC_IV)
+            {
+                value = usci_iv(&uscis[i]);
+            }
+        }
+        break;
+    }
+    if (size == 1)
+    {
+        return (addr & 1) ? value >> 8 : value & 0xFF;
+    }
+    return value;
+}
+
+void flash_write(unsigned long addr, unsigned int value, int size)
+{
+    unsigned int control = peek16(FCTL1);
+    unsigned long i, segment;
+
+    if (peek16(FCTL3) & 0x0010) // LOCK
+    {
+        return;
+    }
+    if (control & 0x0006) // ERASE or MERAS: the segment written to
+    {
+        segment = addr < 0x4400 ? 128 : 512;
+        for (i = addr & ~(segment - 1); i < (addr & ~(segment - 1)) + segment; i++)
+        {
+            mem[i] = 0xFF;
+        }
+    }
+    else if (control & 0x00C0) // WRT or BLKWRT, programming only clears bits
+    {
+        mem[addr] &= value & 0xFF;
+        if (size == 2)
+        {
+            mem[addr + 1] &= value >> 8;
+        }
+    }
+}
+
+void io_write(unsigned long addr, unsigned int value, int size)
+{
+    unsigned long word = addr & ~1UL;
+    int i;
+
+    switch (word)
+    {
+    case WDTCTL:
+        if (size == 1 || (value >> 8) != 0x5A)
+        {
+            puc();
+            return;
+        }
+        if (value & 0x0008) // WDTCNTCL
+        {
+            wdt_count = 0;
+        }
+        poke16(WDTCTL, value & 0xF7);
+        return;
+    case FCTL1:
+    case FCTL3:
+    case FCTL4:
+        if (size == 2 && (value >> 8) == 0xA5)
+        {
+            poke16(word, value & 0xFF);
+        }
+        return;
+    case P1IV:
+    case P2IV:
+    case DMAIV:
+        return;
+    }
+    for (i = 0; i < DMAS; i++)
+    {
+        if (word == (unsigned long)(DMA0CTL + 0x10 * i))
+        {
+            dma_control(i, size == 1 ? (peek16(word) & ~0xFF) | (value & 0xFF) : value);
+            return;
+        }
+    }
+    for (i = 0; i < USCIS; i++)
+    {
+        if (word == uscis[i].base + UC_TXBUF)
+        {
+            usci_transmit(&uscis[i], value & 0xFF);
+            return;
+        }
+    }
+
+    if (size == 1)
+    {
+        mem[addr] = value;
+    }
+    else
+    {
+        poke16(word, value);
+    }
+
+    if (word == ADC12CTL0 && (peek16(ADC12CTL0) & 0x0003) == 0x0003) // ENC and SC
+    {
+        unsigned int reading = adc_value;
+        if (knob_period && (cycles / knob_period) & 1)
+        {
+            reading ^= 0x800;
+        }
+        poke16(ADC12MEM0, reading & 0x0FFF);
+        mem[ADC12IFG] |= 1;
+        poke16(ADC12CTL0, peek16(ADC12CTL0) & ~1);
+    }
+    for (i = 0; i < TIMERS; i++)
+    {
+        if (word == timers[i].base && (value & 0x0004)) // TACLR
+        {
+            poke16(timers[i].base + 0x10, 0);
+            poke16(timers[i].base, peek16(timers[i].base) & ~0x0004);
+            timers[i].prescale = 0;
+        }
+    }
+}
+
+/* Memory, size is 1 (byte), 2 (word) or 4 (20-bit address word) */
+
+unsigned long read_mem(unsigned long addr, int size)
+{
+    addr &= ADDR_MASK;
+    if (size == 4)
+    {
+        return read_mem(addr, 2) | ((read_mem(addr + 2, 2) & 0x0F) << 16);
+    }
+    if (size == 2)
+    {
+        addr &= ~1UL;
+    }
+    if (addr < 0x1000)
+    {
+        return io_read(addr, size);
+    }
+    return size == 1 ? mem[addr] : peek16(addr);
+}
+
+void write_mem(unsigned long addr, unsigned long value, int size)
+{
+    addr &= ADDR_MASK;
+    if (size == 4)
+    {
+        write_mem(addr, value & 0xFFFF, 2);
+        write_mem(addr + 2, (value >> 16) & 0x0F, 2);
+        return;
+    }
+    if (size == 2)
+    {
+        addr &= ~1UL;
+    }
+    if (addr < 0x1000)
+    {
+        io_write(addr, value, size);
+    }
+    else if ((addr >= 0x1800 && addr < 0x1A00) || addr >= 0x4400)
+    {
+        flash_write(addr, value, size);
+    }
+    else if (size == 1)
+    {
+        mem[addr] = value;
+    }
+    else
+    {
+        poke16(addr, value);
+    }
+}
+
+/* Time */
+
+void timer_tick(struct timer *t, int mode)
+{
+    unsigned int count = peek16(t->base + 0x10);
+    unsigned int ccr0 = peek16(t->base + 0x12);
+    int n;
+
+    if (mode == 2) // continuous
+    {
+        count = (count + 1) & 0xFFFF;
+        if (count == 0)
+        {
+            poke16(t->base, peek16(t->base) | 1);
+        }
+    }
+    else // up (up/down is counted as up)
+    {
+        if (ccr0 == 0)
+        {
+            return; // stopped
+        }
+        if (count >= ccr0)
+        {
+            count = 0;
+            poke16(t->base, peek16(t->base) | 1);
+        }
+        else
+        {
+            count++;
+        }
+    }
+    poke16(t->base + 0x10, count);
+    for (n = 0; n < t->ccrs; n++)
+    {
+        unsigned int cctl = peek16(t->base + 2 + 2 * n);
+        if (!(cctl & 0x0100) && count == peek16(t->base + 0x12 + 2 * n)) // compare mode
+        {
+            poke16(t->base + 2 + 2 * n, cctl | 1);
+            if (n == 0 || n == 2)
+            {
+                dma_trigger(t->dma_triggers[n / 2]);
+            }
+        }
+    }
+}
+
+void advance(unsigned int n)
+{
+    static const unsigned long long wdt_intervals[8] = {
+        1ULL << 31, 1ULL << 27, 1ULL << 23, 1ULL << 19, 1ULL << 15, 1ULL << 13, 1ULL << 9, 1ULL << 6};
+    unsigned int wdt = peek16(WDTCTL);
+    int i;
+
+    cycles += n;
+    for (i = 0; i < TIMERS; i++)
+    {
+        struct timer *t = &timers[i];
+        unsigned int control = peek16(t->base);
+        int mode = (control >> 4) & 3;
+        int source = (control >> 8) & 3;
+        unsigned long divider;
+
+        if (mode == 0 || source == 0 || source == 3)
+        {
+            continue;
+        }
+        divider = (1UL << ((control >> 6) & 3)) * ((peek16(t->base + 0x20) & 7) + 1);
+        if (source == 1)
+        {
+            divider *= aclk_divider;
+        }
+        t->prescale += n;
+        while (t->prescale >= divider)
+        {
+            t->prescale -= divider;
+            timer_tick(t, mode);
+        }
+    }
+
+    if (!(wdt & 0x0080) && !(wdt & 0x0010)) // running in watchdog mode
+    {
+        wdt_count += ((wdt >> 5) & 3) == 1 ? (n + aclk_divider - 1) / aclk_divider : n;
+        if (wdt_count >= wdt_intervals[wdt & 7])
+        {
+            puc();
+        }
+    }
+
+    for (i = 0; i < USCIS; i++)
+    {
+        struct usci *u = &uscis[i];
+        if (u->shift_end && cycles >= u->shift_end)
+        {
+            if (u->out != NULL)
+            {
+                fputc(u->shift, u->out);
+            }
+            u->shift_end = 0;
+            if (u->buffered)
+            {
+                u->buffered = 0;
+                usci_transmit(u, mem[u->base + UC_TXBUF]);
+            }
+        }
+    }
+
+    while (link_next < link_count && cycles >= link_bytes[link_next].cycle)
+    {
+        mem[uscis[1].base + UC_RXBUF] = link_bytes[link_next++].value;
+        mem[uscis[1].base + UC_IE + 1] |= UCRXIFG;
+    }
+}
+
+// Moves one unit for a channel that was triggered, 0 if none was
+int dma_step()
+{
+    int n;
+
+    for (n = 0; n < DMAS; n++)
+    {
+        unsigned long base = DMA0CTL + 0x10 * n;
+        unsigned int control = peek16(base);
+        struct dma *d = &dmas[n];
+        int source_size = (control & DMASRCBYTE) ? 1 : 2;
+        int destination_size = (control & DMADSTBYTE) ? 1 : 2;
+
+        if (!d->requested || !(control & DMAEN))
+        {
+            continue;
+        }
+        d->requested = 0;
+        write_mem(d->destination, read_mem(d->source, source_size), destination_size);
+        if (((control >> 8) & 3) >= 2) // DMASRCINCR: 2 down, 3 up
+        {
+            d->source += ((control >> 8) & 3) == 3 ? source_size : -source_size;
+        }
+        if (((control >> 10) & 3) >= 2)
+        {
+            d->destination += ((control >> 10) & 3) == 3 ? destination_size : -destination_size;
+        }
+        if (--d->size == 0)
+        {
+            poke16(base, (peek16(base) & ~DMAEN) | DMAIFG);
+        }
+        advance(2);
+        return 1;
+    }
+    return 0;
+}
+
+// Highest priority interrupt that is enabled and pending, 0 if none
+unsigned int pending_vector(int *timer_ccr0)
+{
+    unsigned int vector = 0;
+    int i, n;
+
+    *timer_ccr0 = -1;
+    for (i = 0; i < TIMERS; i++)
+    {
+        struct timer *t = &timers[i];
+        if ((peek16(t->base + 2) & 0x0011) == 0x0011 && t->vector_ccr0 > vector)
+        {
+            vector = t->vector_ccr0;
+            *timer_ccr0 = i;
+        }
+        for (n = 1; n < t->ccrs; n++)
+        {
+            if ((peek16(t->base + 2 + 2 * n) & 0x0011) == 0x0011 && t->vector > vector)
+            {
+                vector = t->vector;
+                *timer_ccr0 = -1;
+            }
+        }
+        if ((peek16(t->base) & 0x0003) == 0x0003 && t->vector > vector)
+        {
+            vector = t->vector;
+            *timer_ccr0 = -1;
+        }
+    }
+    if ((mem[PAIE] & mem[PAIFG]) && 0xFFDE > vector)
+    {
+        vector = 0xFFDE;
+        *timer_ccr0 = -1;
+    }
+    if ((mem[PAIE + 1] & mem[PAIFG + 1]) && 0xFFD4 > vector)
+    {
+        vector = 0xFFD4;
+        *timer_ccr0 = -1;
+    }
+    for (i = 0; i < USCIS; i++)
+    {
+        unsigned long ie = uscis[i].base + UC_IE;
+        if ((mem[ie] & mem[ie + 1] & 0x03) && uscis[i].vector > vector)
+        {
+            vector = uscis[i].vector;
+            *timer_ccr0 = -1;
+        }
+    }
+    for (n = 0; n < DMAS; n++)
+    {
+        if ((peek16(DMA0CTL + 0x10 * n) & (DMAIE | DMAIFG)) == (DMAIE | DMAIFG) && DMA_VECTOR > vector)
+        {
+            vector = DMA_VECTOR;
+            *timer_ccr0 = -1;
+        }
+    }
+    return vector;
+}
+
+void interrupt(unsigned int vector, int timer_ccr0)
+{
+    if (timer_ccr0 >= 0)
+    {
+        unsigned long cctl0 = timers[timer_ccr0].base + 2;
+        poke16(cctl0, peek16(cctl0) & ~1);
+    }
+    reg[SP] = (reg[SP] - 2) & ADDR_MASK;
+    write_mem(reg[SP], reg[PC] & 0xFFFF, 2);
+    reg[SP] = (reg[SP] - 2) & ADDR_MASK;
+    write_mem(reg[SP], ((reg[PC] >> 4) & 0xF000) | (reg[SR] & 0x0FFF), 2);
+    reg[SR] &= SR_SCG0;
+    reg[PC] = peek16(vector);
+    push_frame(reg[PC]);
+    advance(6);
+}
+
+/* Instructions */
+
+unsigned long fetch()
+{
+    unsigned long word = peek16(reg[PC]);
+    reg[PC] = (reg[PC] + 2) & ADDR_MASK;
+    return word;
+}
+
+unsigned long size_mask(int size)
+{
+    return size == 1 ? 0xFF : size == 2 ? 0xFFFF : 0xFFFFF;
+}
+
+unsigned long size_msb(int size)
+{
+    return size == 1 ? 0x80 : size == 2 ? 0x8000 : 0x80000;
+}
+
+void set_register(int r, unsigned long value, int size)
+{
+    if (r == CG)
+    {
+        return;
+    }
+    reg[r] = value & size_mask(size);
+    if (r == PC)
+    {
+        reg[PC] &= ~1UL;
+    }
+}
+
+void set_flags(unsigned long result, int size, int carry, int overflow)
+{
+    reg[SR] &= ~(SR_C | SR_Z | SR_N | SR_V);
+    result &= size_mask(size);
+    if (result == 0)
+    {
+        reg[SR] |= SR_Z;
+    }
+    if (result & size_msb(size))
+    {
+        reg[SR] |= SR_N;
+    }
+    if (carry)
+    {
+        reg[SR] |= SR_C;
+    }
+    if (overflow)
+    {
+        reg[SR] |= SR_V;
+    }
+}
+
+#define OPERAND_REGISTER 0
+#define OPERAND_MEMORY 1
+#define OPERAND_CONSTANT 2
+
+struct operand
+{
+    int kind;
+    int mode; // As or Ad, constants count as register mode
+    int reg;
+    unsigned long addr;
+    unsigned long value;
+};
+
+/* Fetches the extension of an index (16 bit, or 20 bit with the
+ * extension word), returns the address relative to base */
+unsigned long index_address(unsigned long base, int extended, unsigned long high)
+{
+    unsigned long index = fetch();
+    if (extended)
+    {
+        index |= high << 16;
+        if (index & 0x80000)
+        {
+            index |= ~0xFFFFFUL;
+        }
+        return (base + index) & ADDR_MASK;
+    }
+    if (index & 0x8000)
+    {
+        index |= ~0xFFFFUL;
+    }
+    return base < 0x10000 ? (base + index) & 0xFFFF : (base + index) & ADDR_MASK;
+}
+
+// 16-bit index on a 20-bit base, as MOVA and CALLA use it
+unsigned long index_address20(unsigned long base)
+{
+    unsigned long index = fetch();
+    if (index & 0x8000)
+    {
+        index |= ~0xFFFFUL;
+    }
+    return (base + index) & ADDR_MASK;
+}
+
+void decode_source(struct operand *op, int as, int r, int size, int extended, unsigned long high)
+{
+    static const long constants[2][4] = {{0, 0, 4, 8}, {0, 1, 2, -1}}; // R2, R3
+
+    op->mode = as;
+    op->reg = r;
+    op->kind = OPERAND_MEMORY;
+    if ((r == SR && as >= 2) || r == CG)
+    {
+        op->kind = OPERAND_CONSTANT;
+        op->value = constants[r - SR][as] & size_mask(size);
+        op->mode = 0;
+        return;
+    }
+    switch (as)
+    {
+    case 0:
+        op->kind = OPERAND_REGISTER;
+        op->value = reg[r] & size_mask(size);
+        return;
+    case 1:
+        op->addr = r == SR ? (extended ? (high << 16) | fetch() : fetch())
+                           : index_address(r == PC ? reg[PC] : reg[r], extended, high);
+        break;
+    case 2:
+        op->addr = reg[r];
+        break;
+    default:
+        if (r == PC)
+        {
+            op->kind = OPERAND_CONSTANT;
+            op->value = fetch();
+            if (extended)
+            {
+                op->value |= high << 16;
+            }
+            op->value &= size_mask(size);
+            return;
+        }
+        op->addr = reg[r];
+        reg[r] = (reg[r] + (size == 4 ? 4 : size == 1 && r != SP ? 1 : 2)) & ADDR_MASK;
+        break;
+    }
+    op->value = read_mem(op->addr, size);
+}
+
+void decode_destination(struct operand *op, int ad, int r, int extended, unsigned long high)
+{
+    op->mode = ad;
+    op->reg = r;
+    if (ad == 0)
+    {
+        op->kind = OPERAND_REGISTER;
+        return;
+    }
+    op->kind = OPERAND_MEMORY;
+    op->addr = r == SR ? (extended ? (high << 16) | fetch() : fetch())
+                       : index_address(r == PC ? reg[PC] : reg[r], extended, high);
+}
+
+unsigned long read_operand(struct operand *op, int size)
+{
+    if (op->kind == OPERAND_REGISTER)
+    {
+        return reg[op->reg] & size_mask(size);
+    }
+    return read_mem(op->addr, size);
+}
+
+void write_operand(struct operand *op, unsigned long value, int size)
+{
+    if (op->kind == OPERAND_REGISTER)
+    {
+        set_register(op->reg, value, size);
+    }
+    else
+    {
+        write_mem(op->addr, value & size_mask(size), size);
+    }
+}
+
+unsigned long add(unsigned long a, unsigned long b, int carry, int size, int flags)
+{
+    unsigned long mask = size_mask(size);
+    unsigned long result = (a & mask) + (b & mask) + carry;
+    if (flags)
+    {
+        unsigned long msb = size_msb(size);
+        set_flags(result, size, result > mask, !((a ^ b) & msb) && ((a ^ result) & msb));
+    }
+    return result & mask;
+}
+
+unsigned long decimal_add(unsigned long a, unsigned long b, int size)
+{
+    int digits = size == 1 ? 2 : size == 2 ? 4 : 5;
+    int carry = (reg[SR] & SR_C) != 0;
+    unsigned long result = 0;
+    int i;
+
+    for (i = 0; i < digits; i++)
+    {
+        int digit = ((a >> (4 * i)) & 0xF) + ((b >> (4 * i)) & 0xF) + carry;
+        carry = digit > 9;
+        if (carry)
+        {
+            digit -= 10;
+        }
+        result |= (unsigned long)(digit & 0xF) << (4 * i);
+    }
+    set_flags(result, size, carry, 0);
+    return result;
+}
+
+int format_one_cycles(int opcode, struct operand *src, struct operand *dst)
+{
+    static const int source_cycles[4] = {1, 3, 2, 2}; // by As: Rn, X(Rn), @Rn, @Rn+
+    int base = src->kind == OPERAND_CONSTANT && src->mode == 3 ? 2 : source_cycles[src->mode];
+
+    if (dst->kind == OPERAND_REGISTER)
+    {
+        if (dst->reg == PC)
+        {
+            return base + (src->kind == OPERAND_CONSTANT && src->mode == 3 ? 1 : 2);
+        }
+        return base;
+    }
+    // MOV, CMP and BIT do not write back
+    return base + 3 - (opcode == 0x4 || opcode == 0x9 || opcode == 0xB);
+}
+
+int format_one(unsigned long word, unsigned long extension)
+{
+    int opcode = word >> 12;
+    int rs = (word >> 8) & 0xF, ad = (word >> 7) & 1, as = (word >> 4) & 3, rd = word & 0xF;
+    int byte = (word >> 6) & 1;
+    int size = 2;
+    int repeat = 1, carry_zero = 0;
+    int registers_only = as == 0 && ad == 0;
+    int n, cycles_used;
+    int returns = opcode == 0x4 && as == 3 && rs == SP && ad == 0 && rd == PC;
+    unsigned long sp = reg[SP];
+    struct operand src, dst;
+
+    if (extension)
+    {
+        size = (extension & 0x40) ? (byte ? 1 : 2) : (byte ? 4 : 2);
+        if (registers_only)
+        {
+            repeat = (extension & 0x80) ? (reg[extension & 0xF] & 0xF) + 1 : (extension & 0xF) + 1;
+            carry_zero = (extension & 0x100) != 0;
+        }
+    }
+    else if (byte)
+    {
+        size = 1;
+    }
+
+    decode_source(&src, as, rs, size, extension && !registers_only, (extension >> 7) & 0xF);
+    decode_destination(&dst, ad, rd, extension && !registers_only, extension & 0xF);
+
+    for (n = 0; n < repeat; n++)
+    {
+        unsigned long a = src.value, b = 0, result = 0;
+        unsigned long msb = size_msb(size);
+        int carry = carry_zero ? 0 : (reg[SR] & SR_C) != 0;
+        int write = 1;
+
+        if (n > 0 && src.kind == OPERAND_REGISTER)
+        {
+            a = reg[src.reg] & size_mask(size);
+        }
+        if (opcode != 0x4)
+        {
+            b = read_operand(&dst, size);
+        }
+        switch (opcode)
+        {
+        case 0x4: // MOV
+            result = a;
+            break;
+        case 0x5: // ADD
+            result = add(b, a, 0, size, 1);
+            break;
+        case 0x6: // ADDC
+            result = add(b, a, carry, size, 1);
+            break;
+        case 0x7: // SUBC
+            result = add(b, ~a, carry, size, 1);
+            break;
+        case 0x8: // SUB
+            result = add(b, ~a, 1, size, 1);
+            break;
+        case 0x9: // CMP
+            add(b, ~a, 1, size, 1);
+            write = 0;
+            break;
+        case 0xA: // DADD
+            result = decimal_add(b, a, size);
+            break;
+        case 0xB: // BIT
+            result = a & b;
+            set_flags(result, size, (result & size_mask(size)) != 0, 0);
+            write = 0;
+            break;
+        case 0xC: // BIC
+            result = b & ~a;
+            break;
+        case 0xD: // BIS
+            result = b | a;
+            break;
+        case 0xE: // XOR
+            result = a ^ b;
+            set_flags(result, size, (result & size_mask(size)) != 0, (a & msb) && (b & msb));
+            break;
+        default: // AND
+            result = a & b;
+            set_flags(result, size, (result & size_mask(size)) != 0, 0);
+            break;
+        }
+        if (write)
+        {
+            write_operand(&dst, result, size);
+        }
+    }
+
+    if (repeat > 1)
+    {
+        cycles_used = repeat + 1;
+    }
+    else
+    {
+        cycles_used = format_one_cycles(opcode, &src, &dst) + (extension != 0);
+        if (size == 4)
+        {
+            cycles_used += (src.kind == OPERAND_MEMORY) + (dst.kind == OPERAND_MEMORY);
+        }
+    }
+    if (returns)
+    {
+        advance(cycles_used);
+        pop_frames(sp);
+        return 0;
+    }
+    return cycles_used;
+}
+
+int format_two(unsigned long word, unsigned long extension)
+{
+    static const int shift_cycles[4] = {1, 4, 3, 3};
+    static const int call_cycles[4] = {4, 5, 4, 4};
+    int opcode = (word >> 7) & 7;
+    int byte = (word >> 6) & 1;
+    int as = (word >> 4) & 3, r = word & 0xF;
+    int size = byte ? 1 : 2;
+    int repeat = 1, carry_zero = 0;
+    int n, cycles_used;
+    struct operand op;
+
+    if (extension)
+    {
+        size = (extension & 0x40) ? (byte ? 1 : 2) : (byte ? 4 : 2);
+        if (as == 0)
+        {
+            repeat = (extension & 0x80) ? (reg[extension & 0xF] & 0xF) + 1 : (extension & 0xF) + 1;
+            carry_zero = (extension & 0x100) != 0;
+        }
+    }
+    decode_source(&op, as, r, size, extension && as != 0, extension & 0xF);
+
+    if (opcode == 4) // PUSH
+    {
+        reg[SP] = (reg[SP] - (size == 4 ? 4 : 2)) & ADDR_MASK;
+        write_mem(reg[SP], op.value, size == 1 ? 1 : size);
+        cycles_used = (op.kind == OPERAND_MEMORY && as == 1) ? 4 : 3;
+        return cycles_used + (extension != 0);
+    }
+    if (opcode == 5) // CALL
+    {
+        unsigned long target = op.value & 0xFFFF;
+        reg[SP] = (reg[SP] - 2) & ADDR_MASK;
+        write_mem(reg[SP], reg[PC] & 0xFFFF, 2);
+        reg[PC] = target & ~1UL;
+        push_frame(reg[PC]);
+        cycles_used = call_cycles[op.mode];
+        if (as == 1 && r == SR)
+        {
+            cycles_used = 6; // CALL &EDE
+        }
+        return cycles_used;
+    }
+
+    for (n = 0; n < repeat; n++)
+    {
+        unsigned long value = n == 0 ? op.value : read_operand(&op, size);
+        unsigned long msb = size_msb(size);
+        unsigned long result;
+        int carry = carry_zero ? 0 : (reg[SR] & SR_C) != 0;
+
+        switch (opcode)
+        {
+        case 0: // RRC
+            result = (value >> 1) | (carry ? msb : 0);
+            set_flags(result, size, value & 1, 0);
+            break;
+        case 1: // SWPB
+            result = ((value & 0xFF) << 8) | ((value >> 8) & 0xFF);
+            break;
+        case 2: // RRA
+            result = (value >> 1) | (value & msb);
+            set_flags(result, size, value & 1, 0);
+            break;
+        default: // SXT, in a register bit 7 goes up to bit 19
+            result = (value & 0x80) ? value | 0xFFF00 : value & 0xFF;
+            if (op.kind == OPERAND_REGISTER)
+            {
+                size = 4;
+            }
+            set_flags(result, size, (result & size_mask(size)) != 0, 0);
+            break;
+        }
+        if (op.kind == OPERAND_REGISTER)
+        {
+            set_register(op.reg, result, size);
+        }
+        else
+        {
+            write_mem(op.addr, result & size_mask(size), size);
+        }
+    }
+    cycles_used = repeat > 1 ? repeat + 1 : shift_cycles[op.mode] + (extension != 0);
+    return cycles_used;
+}
+
+int calla(unsigned long word)
+{
+    int mode = (word >> 4) & 0xF, r = word & 0xF;
+    unsigned long target;
+    int cycles_used = 5;
+
+    switch (mode)
+    {
+    case 0x4: // CALLA Rdst
+        target = reg[r];
+        break;
+    case 0x5: // CALLA x(Rdst)
+        target = read_mem(index_address20(reg[r]), 4);
+        break;
+    case 0x6: // CALLA @Rdst
+        target = read_mem(reg[r], 4);
+        break;
+    case 0x7: // CALLA @Rdst+
+        target = read_mem(reg[r], 4);
+        reg[r] = (reg[r] + 4) & ADDR_MASK;
+        break;
+    case 0x8: // CALLA &abs20
+        target = read_mem((r << 16) | fetch(), 4);
+        cycles_used = 6;
+        break;
+    case 0x9: // CALLA EDE
+        target = read_mem(index_address(reg[PC], 1, r), 4);
+        cycles_used = 6;
+        break;
+    default: // CALLA #imm20
+        target = (r << 16) | fetch();
+        break;
+    }
+    reg[SP] = (reg[SP] - 4) & ADDR_MASK;
+    write_mem(reg[SP], reg[PC], 4);
+    reg[PC] = target & ADDR_MASK & ~1UL;
+    push_frame(reg[PC]);
+    return cycles_used;
+}
+
+int reti()
+{
+    unsigned long sp = reg[SP];
+    unsigned long status = read_mem(reg[SP], 2);
+    reg[SP] = (reg[SP] + 2) & ADDR_MASK;
+    reg[PC] = read_mem(reg[SP], 2) | ((status & 0xF000) << 4);
+    reg[SP] = (reg[SP] + 2) & ADDR_MASK;
+    reg[SR] = status & 0x0FFF;
+    advance(5);
+    pop_frames(sp);
+    return 0;
+}
+
+int push_pop_multiple(unsigned long word)
+{
+    int count = ((word >> 4) & 0xF) + 1;
+    int r = word & 0xF;
+    int size = (word & 0x0100) ? 2 : 4;
+    int i;
+
+    if (word & 0x0200) // POPM, r is the lowest register
+    {
+        for (i = 0; i < count; i++)
+        {
+            set_register((r + i) & 0xF, read_mem(reg[SP], size), size);
+            reg[SP] = (reg[SP] + size) & ADDR_MASK;
+        }
+    }
+    else // PUSHM, r is the highest register
+    {
+        for (i = 0; i < count; i++)
+        {
+            reg[SP] = (reg[SP] - size) & ADDR_MASK;
+            write_mem(reg[SP], reg[(r - i) & 0xF] & size_mask(size), size);
+        }
+    }
+    return 2 + count * (size / 2);
+}
+
+int shift_multiple(unsigned long word)
+{
+    int count = ((word >> 10) & 3) + 1;
+    int op = (word >> 8) & 3;
+    int size = (word & 0x0010) ? 2 : 4;
+    int r = word & 0xF;
+    unsigned long value = reg[r] & size_mask(size);
+    unsigned long msb = size_msb(size);
+    int carry = (reg[SR] & SR_C) != 0;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        switch (op)
+        {
+        case 0: // RRCM
+        {
+            int out = value & 1;
+            value = (value >> 1) | (carry ? msb : 0);
+            carry = out;
+            break;
+        }
+        case 1: // RRAM
+            carry = value & 1;
+            value = (value >> 1) | (value & msb);
+            break;
+        case 2: // RLAM
+            carry = (value & msb) != 0;
+            value = (value << 1) & size_mask(size);
+            break;
+        default: // RRUM
+            carry = value & 1;
+            value >>= 1;
+            break;
+        }
+    }
+    set_flags(value, size, carry, 0);
+    set_register(r, value, size);
+    return count;
+}
+
+int address_instruction(unsigned long word)
+{
+    int mode = (word >> 4) & 0xF;
+    int rs = (word >> 8) & 0xF, rd = word & 0xF;
+    unsigned long sp = reg[SP];
+    unsigned long value;
+    int cycles_used;
+
+    switch (mode)
+    {
+    case 0x0: // MOVA @Rsrc, Rdst
+        value = read_mem(reg[rs], 4);
+        cycles_used = 3;
+        break;
+    case 0x1: // MOVA @Rsrc+, Rdst
+        value = read_mem(reg[rs], 4);
+        reg[rs] = (reg[rs] + 4) & ADDR_MASK;
+        cycles_used = 3;
+        break;
+    case 0x2: // MOVA &abs20, Rdst
+        value = read_mem((rs << 16) | fetch(), 4);
+        cycles_used = 4;
+        break;
+    case 0x3: // MOVA x(Rsrc), Rdst
+        value = read_mem(index_address20(reg[rs]), 4);
+        cycles_used = 4;
+        break;
+    case 0x4:
+    case 0x5:
+        return shift_multiple(word);
+    case 0x6: // MOVA Rsrc, &abs20
+        write_mem((rd << 16) | fetch(), reg[rs], 4);
+        return 4;
+    case 0x7: // MOVA Rsrc, x(Rdst)
+        write_mem(index_address20(reg[rd]), reg[rs], 4);
+        return 4;
+    case 0x8: // MOVA #imm20, Rdst
+        value = (rs << 16) | fetch();
+        cycles_used = 2;
+        break;
+    case 0x9: // CMPA #imm20, Rdst
+        add(reg[rd], ~((rs << 16) | fetch()), 1, 4, 1);
+        return 3;
+    case 0xA: // ADDA #imm20, Rdst
+        set_register(rd, add(reg[rd], (rs << 16) | fetch(), 0, 4, 1), 4);
+        return 3;
+    case 0xB: // SUBA #imm20, Rdst
+        set_register(rd, add(reg[rd], ~((rs << 16) | fetch()), 1, 4, 1), 4);
+        return 3;
+    case 0xC: // MOVA Rsrc, Rdst
+        value = reg[rs];
+        cycles_used = 1;
+        break;
+    case 0xD: // CMPA Rsrc, Rdst
+        add(reg[rd], ~reg[rs], 1, 4, 1);
+        return 1;
+    case 0xE: // ADDA Rsrc, Rdst
+        set_register(rd, add(reg[rd], reg[rs], 0, 4, 1), 4);
+        return 1;
+    default: // SUBA Rsrc, Rdst
+        set_register(rd, add(reg[rd], ~reg[rs], 1, 4, 1), 4);
+        return 1;
+    }
+    set_register(rd, value, 4);
+    if (rd == PC) // BRA, and RETA for MOVA @SP+, PC
+    {
+        cycles_used += mode == 0xC ? 2 : 1;
+        if (mode == 0x1 && rs == SP)
+        {
+            advance(cycles_used);
+            pop_frames(sp);
+            return 0;
+        }
+    }
+    return cycles_used;
+}
+
+int jump(unsigned long word)
+{
+    unsigned long sr = reg[SR];
+    long offset = word & 0x3FF;
+    int taken;
+
+    if (offset & 0x200)
+    {
+        offset -= 0x400;
+    }
+    switch ((word >> 10) & 7)
+    {
+    case 0: // JNE
+        taken = !(sr & SR_Z);
+        break;
+    case 1: // JEQ
+        taken = (sr & SR_Z) != 0;
+        break;
+    case 2: // JNC
+        taken = !(sr & SR_C);
+        break;
+    case 3: // JC
+        taken = (sr & SR_C) != 0;
+        break;
+    case 4: // JN
+        taken = (sr & SR_N) != 0;
+        break;
+    case 5: // JGE
+        taken = !(sr & SR_N) == !(sr & SR_V);
+        break;
+    case 6: // JL
+        taken = !(sr & SR_N) != !(sr & SR_V);
+        break;
+    default: // JMP
+        taken = 1;
+        break;
+    }
+    if (taken)
+    {
+        reg[PC] = (reg[PC] + 2 * offset) & ADDR_MASK;
+    }
+    return 2;
+}
+
+// Runs one instruction, returns its cycles (0 if it already advanced time)
+int step()
+{
+    unsigned long word = fetch();
+    unsigned long extension = 0;
+
+    if ((word & 0xF800) == 0x1800)
+    {
+        extension = word;
+        word = fetch();
+    }
+    if (word >= 0x4000)
+    {
+        return format_one(word, extension);
+    }
+    if (word >= 0x2000)
+    {
+        return jump(word);
+    }
+    if ((word & 0xFC00) == 0x1000)
+    {
+        if ((word & 0xFFC0) == 0x1300)
+        {
+            return reti();
+        }
+        if (word >= 0x1340 && word < 0x1400)
+        {
+            return calla(word);
+        }
+        return format_two(word, extension);
+    }
+    if ((word & 0xFC00) == 0x1400)
+    {
+        return push_pop_multiple(word);
+    }
+    if (word < 0x1000)
+    {
+        return address_instruction(word);
+    }
+    fprintf(stderr, "illegal instruction %04lx at %05lx\n", word, (reg[PC] - 2) & ADDR_MASK);
+    exit(1);
+}
+
+/* Loading */
+
+unsigned long le16(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+unsigned long le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+int compare_symbols(const void *a, const void *b)
+{
+    const struct symbol *x = a, *y = b;
+    return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
+
+int compare_triggers(const void *a, const void *b)
+{
+    const struct trigger *x = a, *y = b;
+    return x->cycle < y->cycle ? -1 : x->cycle > y->cycle;
+}
+
+int compare_totals(const void *a, const void *b)
+{
+    const struct symbol *x = a, *y = b;
+    return x->total < y->total ? 1 : x->total > y->total ? -1 : 0;
+}
+
+void read_symbols(const unsigned char *elf)
+{
+    unsigned long shoff = le32(elf + 32);
+    int shentsize = le16(elf + 46), shnum = le16(elf + 48);
+    int i, j;
+
+    for (i = 0; i < shnum; i++)
+    {
+        const unsigned char *section = elf + shoff + i * shentsize;
+        const unsigned char *strings;
+        unsigned long offset, size;
+
+        if (le32(section + 4) != 2) // SHT_SYMTAB
+        {
+            continue;
+        }
+        offset = le32(section + 16);
+        size = le32(section + 20);
+        strings = elf + le32(elf + shoff + le32(section + 24) * shentsize + 16);
+        for (j = 0; j * 16UL < size && symbol_count < MAX_SYMBOLS; j++)
+        {
+            const unsigned char *entry = elf + offset + j * 16;
+            if ((entry[12] & 0xF) != 2 || le16(entry + 14) == 0) // defined STT_FUNC
+            {
+                continue;
+            }
+            strncpy(symbols[symbol_count].name, (const char *)strings + le32(entry), sizeof(symbols[0].name) - 1);
+            symbols[symbol_count].addr = le32(entry + 4) & ADDR_MASK & ~1UL;
+            symbols[symbol_count].size = le32(entry + 8);
+            symbol_count++;
+        }
+    }
+    qsort(symbols, symbol_count, sizeof(symbols[0]), compare_symbols);
+    // Hand written assembly has no sizes: run to the next symbol
+    for (i = 0; i < symbol_count; i++)
+    {
+        if (symbols[i].size == 0)
+        {
+            symbols[i].size = i + 1 < symbol_count ? symbols[i + 1].addr - symbols[i].addr : 2;
+        }
+    }
+}
+
+int load_elf(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    unsigned char *elf;
+    long length;
+    unsigned long phoff;
+    int phentsize, phnum, i;
+
+    if (file == NULL)
+    {
+        perror(path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    elf = malloc(length);
+    if (elf == NULL || fread(elf, 1, length, file) != (size_t)length)
+    {
+        fprintf(stderr, "%s: read failed\n", path);
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+
+    if (length < 52 || memcmp(elf, "\177ELF", 4) != 0 || elf[4] != 1 || elf[5] != 1 || le16(elf + 18) != 105)
+    {
+        fprintf(stderr, "%s: not a 32-bit little-endian MSP430 ELF\n", path);
+        return 0;
+    }
+    phoff = le32(elf + 28);
+    phentsize = le16(elf + 42);
+    phnum = le16(elf + 44);
+    for (i = 0; i < phnum; i++)
+    {
+        const unsigned char *header = elf + phoff + i * phentsize;
+        unsigned long offset = le32(header + 4), paddr = le32(header + 12), filesz = le32(header + 16);
+        if (le32(header) != 1 || filesz == 0) // PT_LOAD
+        {
+            continue;
+        }
+        if (paddr + filesz > MEM_SIZE || offset + filesz > (unsigned long)length)
+        {
+            fprintf(stderr, "%s: segment at %05lx does not fit\n", path, paddr);
+            return 0;
+        }
+        memcpy(mem + paddr, elf + offset, filesz); // load address, crt0 copies .data
+    }
+    read_symbols(elf);
+    if (peek16(0xFFFE) == 0)
+    {
+        poke16(0xFFFE, le32(elf + 24));
+    }
+    free(elf);
+    return 1;
+}
+
+int load_raw(const char *path, unsigned long addr)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        perror(path);
+        return 0;
+    }
+    if (fread(mem + addr, 1, MEM_SIZE - addr, file) == 0)
+    {
+        fprintf(stderr, "%s: empty\n", path);
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+    poke16(0xFFFE, addr);
+    return 1;
+}
+
+/* The frame play_music() (or play_effect() with a pitch) sends from the
+ * game MCU, a byte every 8 x AUDIO_LINK_DIVIDER cycles of its SMCLK
+ */
+void queue_frame(const struct trigger *t)
+{
+    unsigned long long byte_cycles = 8ULL * AUDIO_LINK_DIVIDER * mclk_hz / GAME_SMCLK_HZ;
+    unsigned char frame[6];
+    int length = t->pitch ? 2 : 1;
+    int i;
+
+    frame[0] = AUDIO_SYNC;
+    frame[1] = t->pitch ? AUDIO_PLAY_EFFECT : AUDIO_PLAY_SONG;
+    frame[2] = length;
+    frame[3] = t->song;
+    frame[4] = t->pitch;
+    frame[3 + length] = frame[1] + frame[2] + frame[3] + (t->pitch ? frame[4] : 0);
+    for (i = 0; i < length + 4 && link_count < MAX_LINK_BYTES; i++)
+    {
+        link_bytes[link_count].cycle = t->cycle + (i + 1) * byte_cycles;
+        link_bytes[link_count].value = frame[i];
+        link_count++;
+    }
+}
+
+void report(const char *stop)
+{
+    struct symbol *s;
+    int i;
+
+    pop_frames(ADDR_MASK);
+    fprintf(stderr, "%s after %llu cycles, %llu instructions, %llu cycles asleep, %d resets\n",
+            stop, cycles, instructions, sleep_cycles, resets);
+    qsort(symbols, symbol_count, sizeof(symbols[0]), compare_totals);
+    printf("%-32s %10s %14s %14s %10s\n", "function", "calls", "self", "total", "per call");
+    for (i = 0; i < symbol_count; i++)
+    {
+        s = &symbols[i];
+        if (s->calls == 0 && s->self == 0)
+        {
+            continue;
+        }
+        printf("%-32s %10lu %14llu %14llu %10llu\n", s->name, s->calls, s->self, s->total,
+               s->calls ? s->total / s->calls : 0);
+    }
+    if (unknown_cycles)
+    {
+        printf("%-32s %10s %14llu\n", "(no symbol)", "", unknown_cycles);
+    }
+}
+
+/* -x: loads the instructions listed in path one after another at
+ * CHECK_ADDR, then runs each on its own and compares the cycles it is
+ * charged with the count on its line ("cycles words... ; text").
+ */
+#define CHECK_ADDR 0x4400
+#define MAX_CHECKS 256
+
+int check_cycles(const char *path)
+{
+    static struct
+    {
+        unsigned long addr;
+        int cycles;
+        char text[48];
+    } checks[MAX_CHECKS];
+    FILE *file = fopen(path, "r");
+    char line[256];
+    unsigned long addr = CHECK_ADDR;
+    int count = 0, wrong = 0;
+    int i;
+
+    if (file == NULL)
+    {
+        perror(path);
+        return 2;
+    }
+    while (fgets(line, sizeof(line), file) != NULL && count < MAX_CHECKS)
+    {
+        char *p = line, *end;
+        char *text = strchr(line, ';');
+        long cycles_expected = strtol(p, &end, 10);
+
+        if (line[0] == '#' || end == p)
+        {
+            continue;
+        }
+        checks[count].addr = addr;
+        checks[count].cycles = cycles_expected;
+        if (text != NULL)
+        {
+            *text = '\0';
+            strncpy(checks[count].text, text + 1 + (text[1] == ' '), sizeof(checks[0].text) - 1);
+            checks[count].text[strcspn(checks[count].text, "\r\n")] = '\0';
+        }
+        for (p = end;; p = end)
+        {
+            unsigned long word = strtoul(p, &end, 16);
+            if (end == p)
+            {
+                break;
+            }
+            poke16(addr, word);
+            addr += 2;
+        }
+        count++;
+    }
+    fclose(file);
+
+    poke16(0xFFFE, CHECK_ADDR);
+    puc();
+    for (i = 0; i < count; i++)
+    {
+        unsigned long long before = cycles;
+        int used;
+
+        reg[PC] = checks[i].addr;
+        used = step();
+        if (used)
+        {
+            advance(used);
+        }
+        if (cycles - before != (unsigned long long)checks[i].cycles)
+        {
+            printf("%05lx %-24s %llu cycles, not %d\n", checks[i].addr, checks[i].text, cycles - before,
+                   checks[i].cycles);
+            wrong++;
+        }
+    }
+    printf("%d instructions, %d with other cycle counts\n", count, wrong);
+    return wrong != 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *stop_name = NULL;
+    unsigned long stop_addr = ~0UL;
+    long stop_count = 1;
+    unsigned long raw_addr = 0;
+    int raw = 0, check = 0;
+    int i, opt;
+
+    for (opt = 1; opt < argc - 1 && argv[opt][0] == '-'; opt++)
+    {
+        char flag = argv[opt][1];
+        if (flag == 'b' || flag == 'v' || flag == 'x')
+        {
+            button_held |= flag == 'b';
+            trace |= flag == 'v';
+            check |= flag == 'x';
+            continue;
+        }
+        if (opt + 1 >= argc - 1)
+        {
+            break;
+        }
+        const char *arg = argv[++opt];
+        switch (flag)
+        {
+        case 'c':
+            max_cycles = strtoull(arg, NULL, 0);
+            break;
+        case 's':
+        {
+            static char name[64];
+            char *colon;
+            strncpy(name, arg, sizeof(name) - 1);
+            colon = strchr(name, ':');
+            if (colon != NULL)
+            {
+                *colon = '\0';
+                stop_count = strtol(colon + 1, NULL, 0);
+            }
+            stop_name = name;
+            break;
+        }
+        case 'a':
+            adc_value = strtoul(arg, NULL, 0) & 0x0FFF;
+            break;
+        case 'k':
+            knob_period = strtoull(arg, NULL, 0);
+            break;
+        case 'm':
+            mclk_hz = strtoul(arg, NULL, 0);
+            break;
+        case 't':
+            if (trigger_count < MAX_TRIGGERS)
+            {
+                char *colon;
+                triggers[trigger_count].cycle = strtoull(arg, &colon, 0);
+                triggers[trigger_count].song = *colon == ':' ? strtol(colon + 1, &colon, 0) : 0;
+                triggers[trigger_count].pitch = *colon == ':' ? atoi(colon + 1) : 0;
+                trigger_count++;
+            }
+            break;
+        case 'u':
+            uscis[0].out = fopen(arg, "wb");
+            if (uscis[0].out == NULL)
+            {
+                perror(arg);
+                return 2;
+            }
+            break;
+        case 'r':
+            raw = 1;
+            raw_addr = strtoul(arg, NULL, 16) & ADDR_MASK;
+            break;
+        default:
+            opt = argc;
+            break;
+        }
+    }
+    if (opt != argc - 1)
+    {
+        fprintf(stderr, "usage: msp430_sim [-c cycles] [-s sym[:n]] [-a adc] [-k cycles] [-b] [-m hz]\n"
+                        "                  [-t cycle:song[:pitch]]... [-u file] [-r addr] [-v] program.elf\n"
+                        "       msp430_sim -x cycles.txt\n");
+        return 2;
+    }
+    if (check)
+    {
+        return check_cycles(argv[opt]);
+    }
+    if (!(raw ? load_raw(argv[opt], raw_addr) : load_elf(argv[opt])))
+    {
+        return 2;
+    }
+    if (stop_name != NULL)
+    {
+        for (i = 0; i < symbol_count; i++)
+        {
+            if (strcmp(symbols[i].name, stop_name) == 0)
+            {
+                stop_addr = symbols[i].addr;
+            }
+        }
+        if (stop_addr == ~0UL)
+        {
+            fprintf(stderr, "no function %s\n", stop_name);
+            return 2;
+        }
+    }
+
+    aclk_divider = (mclk_hz + ACLK_HZ / 2) / ACLK_HZ;
+    qsort(triggers, trigger_count, sizeof(triggers[0]), compare_triggers);
+    for (i = 0; i < trigger_count; i++)
+    {
+        queue_frame(&triggers[i]);
+    }
+
+    puc();
+    resets = 0;
+    while (cycles < max_cycles)
+    {
+        int timer_ccr0;
+        unsigned int vector = (reg[SR] & SR_GIE) ? pending_vector(&timer_ccr0) : 0;
+        unsigned long pc;
+        unsigned long long before;
+        int used, s;
+
+        if (dma_step())
+        {
+            continue;
+        }
+        if (vector)
+        {
+            interrupt(vector, timer_ccr0);
+            continue;
+        }
+        if (reg[SR] & SR_CPUOFF)
+        {
+            if (!(reg[SR] & SR_GIE))
+            {
+                report("CPU off with interrupts disabled");
+                return 0;
+            }
+            advance(1);
+            sleep_cycles++;
+            continue;
+        }
+        pc = reg[PC];
+        if (pc == stop_addr && --stop_count == 0)
+        {
+            report(stop_name);
+            return 0;
+        }
+        if (trace)
+        {
+            fprintf(stderr, "%10llu %05lx %04x  sp=%05lx sr=%03lx r12=%05lx r13=%05lx r14=%05lx r15=%05lx\n",
+                    cycles, pc, peek16(pc), reg[SP], reg[SR], reg[12], reg[13], reg[14], reg[15]);
+        }
+        before = cycles;
+        used = step();
+        if (used)
+        {
+            advance(used);
+        }
+        instructions++;
+        s = find_symbol(pc);
+        if (s >= 0)
+        {
+            symbols[s].self += cycles - before;
+        }
+        else
+        {
+            unknown_cycles += cycles - before;
+        }
+    }
+    report("cycle limit");
+    return 0;
+}
@@ -0,0 +1,203 @@
+/* pbm_compare.c
+ * Host tool that picks the panel images of an SPI_TRACE build (see
+ * panel_dump in main.c) out of the back-channel UART stream and
+ * compares them with golden images.
+ *
+ *   gcc -o pbm_compare tools/pbm_compare.c
+ *   stty -F /dev/ttyACM1 9600 raw
+ *   ./pbm_compare golden/ out/ < /dev/ttyACM1      (compare)
+ *   ./pbm_compare -u golden/ out/ < /dev/ttyACM1   (take new golden images)
+ *
+ * The golden images in tools/golden are taken on the host, from the
+ * scripted game in tools/golden/capture.txt (see tools/game_emu.c):
+ *
+ *   gcc -DSPI_TRACE -O1 -fno-inline -rdynamic -Itools/emu/game -I. -o game_emu tools/game_emu.c
+ *   ./game_emu -u - tools/golden/capture.txt | ./pbm_compare tools/golden out
+ *
+ * Take them again with -u when a change to the drawing is meant to
+ * show, and check the new images before committing them.
+ *
+ * Every image is saved as out/<label>.pbm (<label>-2.pbm and so on when
+ * a label repeats). If golden/ has the same name, the two are compared
+ * and an XOR image of the differences is saved as out/<label>.diff.pbm.
+ * Exits non-zero if any image differs from its golden image.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#define WIDTH 102
+#define HEIGHT 64
+#define ROW_BYTES ((WIDTH + 7) / 8)
+#define IMAGE_BYTES (ROW_BYTES * HEIGHT)
+#define MAX_LABELS 32
+
+char labels[MAX_LABELS][32];
+int label_counts[MAX_LABELS];
+int label_total = 0;
+
+int write_pbm(const char *path, const char *label, const unsigned char *image)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        perror(path);
+        return 0;
+    }
+    fprintf(file, "P4\n# %s\n%d %d\n", label, WIDTH, HEIGHT);
+    fwrite(image, 1, IMAGE_BYTES, file);
+    fclose(file);
+    return 1;
+}
+
+int read_pbm(const char *path, unsigned char *image)
+{
+    char line[64];
+    int width, height;
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    // Magic, comment, size
+    if (fgets(line, sizeof(line), file) == NULL || strncmp(line, "P4", 2) != 0)
+    {
+        fclose(file);
+        return 0;
+    }
+    do
+    {
+        if (fgets(line, sizeof(line), file) == NULL)
+        {
+            fclose(file);
+            return 0;
+        }
+    } while (line[0] == '#');
+    if (sscanf(line, "%d %d", &width, &height) != 2 || width != WIDTH || height != HEIGHT ||
+        fread(image, 1, IMAGE_BYTES, file) != IMAGE_BYTES)
+    {
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+    return 1;
+}
+
+/* Gives repeated labels a -2, -3 ... suffix */
+void image_name(const char *label, char *name, int size)
+{
+    int i;
+    for (i = 0; i < label_total; i++)
+    {
+        if (strcmp(labels[i], label) == 0)
+        {
+            snprintf(name, size, "%s-%d", label, ++label_counts[i]);
+            return;
+        }
+    }
+    if (label_total < MAX_LABELS)
+    {
+        snprintf(labels[label_total], sizeof(labels[0]), "%s", label);
+        label_counts[label_total++] = 1;
+    }
+    snprintf(name, size, "%s", label);
+}
+
+/* Reads up to the next "P4\n# " in the stream, skipping other output */
+int find_image(void)
+{
+    const char *magic = "P4\n# ";
+    int matched = 0, c;
+    while ((c = getchar()) != EOF)
+    {
+        if (c == magic[matched])
+        {
+            if (magic[++matched] == '\0')
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            matched = (c == magic[0]);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned char image[IMAGE_BYTES], golden[IMAGE_BYTES], diff[IMAGE_BYTES];
+    char label[32], name[48], path[512], size[16];
+    int update = 0, failed = 0, i, c, n;
+
+    if (argc > 1 && strcmp(argv[1], "-u") == 0)
+    {
+        update = 1;
+        argc--;
+        argv++;
+    }
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: pbm_compare [-u] golden_dir out_dir < uart_stream\n");
+        return 2;
+    }
+
+    while (find_image())
+    {
+        for (n = 0; (c = getchar()) != EOF && c != '\n' && n < (int)sizeof(label) - 1; n++)
+        {
+            label[n] = c;
+        }
+        label[n] = '\0';
+        for (n = 0; (c = getchar()) != EOF && c != '\n' && n < (int)sizeof(size) - 1; n++)
+        {
+            size[n] = c;
+        }
+        size[n] = '\0';
+        if (strcmp(size, "102 64") != 0 || fread(image, 1, IMAGE_BYTES, stdin) != IMAGE_BYTES)
+        {
+            fprintf(stderr, "%s: truncated image\n", label);
+            failed = 1;
+            continue;
+        }
+
+        image_name(label, name, sizeof(name));
+        snprintf(path, sizeof(path), "%s/%s.pbm", argv[2], name);
+        write_pbm(path, label, image);
+
+        snprintf(path, sizeof(path), "%s/%s.pbm", argv[1], name);
+        if (update)
+        {
+            write_pbm(path, label, image);
+            printf("%s: saved as golden\n", name);
+            continue;
+        }
+        if (!read_pbm(path, golden))
+        {
+            printf("%s: no golden image\n", name);
+            continue;
+        }
+
+        n = 0;
+        for (i = 0; i < IMAGE_BYTES; i++)
+        {
+            unsigned char bits = image[i] ^ golden[i];
+            diff[i] = bits;
+            for (; bits != 0; bits &= bits - 1)
+            {
+                n++;
+            }
+        }
+        if (n == 0)
+        {
+            printf("%s: ok\n", name);
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s.diff.pbm", argv[2], name);
+        write_pbm(path, label, diff);
+        printf("%s: %d pixels differ, see %s\n", name, n, path);
+        failed = 1;
+    }
+
+    return failed;
+}
@@ -0,0 +1,584 @@
+/* song_table.c
+ * Host tool that generates songs.h, the packed note tables music.c
+ * plays, from a text score (tools/songs.txt) that can pull melodies out
+ * of MIDI files.
+ *
+ *   gcc -o song_table tools/song_table.c -lm
+ *   ./song_table tools/songs.txt > songs.h
+ *
+ * Score lines ('#' starts a comment):
+ *   song <name> <ms>          start <name>_notes, notes <ms> long
+ *   tempo <ms>                change the note length of the song
+ *   midi <name> <file> [n]    <name>_notes from track n of a MIDI file
+ *                             (default: the first track with notes)
+ * and notes, separated by spaces:
+ *   C4 F#3 Bb5                note names, octave 4 holds middle C
+ *   300                       a frequency in Hz
+ *   R                         a rest
+ *   G4*2 C4/2                 twice or half the note length
+ *   [ ... ]3                  play the bracketed notes 3 times in all
+ *
+ * MIDI tracks are played one note at a time: a new note cuts off the one
+ * sounding, and the gaps between notes become rests. Note lengths follow
+ * the tempo changes of every track. Frequencies are rounded to whole Hz,
+ * the same as the old NOTE_* table of music.c.
+ *
+ * The phase steps and tick counts are written as NOTE_STEP() and
+ * NOTE_MS() (see audio_link.h), so they are worked out by the compiler
+ * for the audio MCU's SYNTH_RATE and SONG_TICK_HZ.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NOTES 1024
+#define MAX_SONGS 32
+#define MAX_MS 3999       // NOTE_MS() of this still fits 16 bits
+#define MIN_HZ 1
+#define MAX_HZ 7995       // half of SYNTH_RATE
+#define MAX_TEMPOS 256
+#define MIDI_MAX_EVENTS 8192
+#define NOTE_REST 0
+#define NOTE_REPEAT -1
+
+struct entry
+{
+    int hz;       // NOTE_REST, NOTE_REPEAT or a frequency
+    int ms;       // length, or the repeat count for NOTE_REPEAT
+    int back;     // NOTE_REPEAT only
+    char name[8]; // for the comment
+};
+
+struct entry notes[MAX_NOTES];
+int note_count = 0;
+char song_names[MAX_SONGS][32];
+int song_count = 0;
+
+const char *score_file = "";
+int line_number = 0;
+
+void fail(const char *message, const char *detail)
+{
+    fprintf(stderr, "%s:%d: %s %s\n", score_file, line_number, message, detail);
+    exit(1);
+}
+
+/* Appends a note, splitting anything longer than MAX_MS */
+void add_note(int hz, int ms, const char *name)
+{
+    if (hz != NOTE_REST && (hz < MIN_HZ || hz > MAX_HZ))
+    {
+        fail("frequency out of range:", name);
+    }
+    if (ms <= 0)
+    {
+        return;
+    }
+    while (ms > 0)
+    {
+        if (note_count == MAX_NOTES)
+        {
+            fail("too many notes", "");
+        }
+        notes[note_count].hz = hz;
+        notes[note_count].ms = ms > MAX_MS ? MAX_MS : ms;
+        notes[note_count].back = 0;
+        strncpy(notes[note_count].name, name, sizeof(notes[0].name) - 1);
+        notes[note_count].name[sizeof(notes[0].name) - 1] = 0;
+        note_count++;
+        ms -= MAX_MS;
+    }
+}
+
+int key_hz(int key)
+{
+    return (int)floor(440.0 * pow(2.0, (key - 69) / 12.0) + 0.5);
+}
+
+void key_name(int key, char *name)
+{
+    static const char *names[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+    key &= 0x7F;
+    sprintf(name, "%s%d", names[key % 12], key / 12 - 1);
+}
+
+/* Returns the MIDI key of a note name like C4, F#3 or Bb5, -1 if it is not one */
+int parse_key(const char *name)
+{
+    static const int semitones[7] = {9, 11, 0, 2, 4, 5, 7}; // A..G
+    int key;
+
+    if (name[0] < 'A' || name[0] > 'G')
+    {
+        return -1;
+    }
+    key = semitones[name[0] - 'A'];
+    name++;
+    if (*name == '#' || *name == 's')
+    {
+        key++;
+        name++;
+    }
+    else if (*name == 'b')
+    {
+        key--;
+        name++;
+    }
+    if (*name < '0' || *name > '8' || name[1] != 0)
+    {
+        return -1;
+    }
+    return key + 12 * (*name - '0' + 1);
+}
+
+void start_song(const char *name)
+{
+    int i;
+
+    if (song_count == MAX_SONGS)
+    {
+        fail("too many songs", "");
+    }
+    for (i = 0; i < song_count; i++)
+    {
+        if (strcmp(song_names[i], name) == 0)
+        {
+            fail("song defined twice:", name);
+        }
+    }
+    strncpy(song_names[song_count], name, sizeof(song_names[0]) - 1);
+    song_count++;
+}
+
+/* Closes a song: writes its table and forgets its notes */
+void print_song(void)
+{
+    int i;
+
+    printf("const struct note %s_notes[] =\n{\n", song_names[song_count - 1]);
+    for (i = 0; i < note_count; i++)
+    {
+        if (notes[i].hz == NOTE_REPEAT)
+        {
+            printf("    {NOTE_REPEAT, NOTE_AGAIN(%d, %d)},\n", notes[i].ms, notes[i].back);
+        }
+        else if (notes[i].hz == NOTE_REST)
+        {
+            printf("    {NOTE_REST, NOTE_MS(%d)},\n", notes[i].ms);
+        }
+        else
+        {
+            printf("    {NOTE_STEP(%d), NOTE_MS(%d)}, // %s\n", notes[i].hz, notes[i].ms, notes[i].name);
+        }
+    }
+    printf("    {0, 0},\n};\n\n");
+    note_count = 0;
+}
+
+/* MIDI */
+
+unsigned char *midi;
+long midi_size;
+
+struct tempo
+{
+    long tick;
+    long us_per_beat;
+} tempos[MAX_TEMPOS];
+int tempo_count;
+long ticks_per_beat;
+
+struct event
+{
+    long tick;
+    int key;
+    int on;
+} events[MIDI_MAX_EVENTS];
+int event_count;
+
+long midi_word(long at, int bytes)
+{
+    long value = 0;
+    while (bytes--)
+    {
+        if (at >= midi_size)
+        {
+            fail("MIDI file cut short", "");
+        }
+        value = (value << 8) | midi[at++];
+    }
+    return value;
+}
+
+long midi_varlen(long *at, long end)
+{
+    long value = 0;
+    int c;
+    do
+    {
+        if (*at >= end)
+        {
+            fail("MIDI track cut short", "");
+        }
+        c = midi[(*at)++];
+        value = (value << 7) | (c & 0x7F);
+    } while (c & 0x80);
+    return value;
+}
+
+/* Reads the track from at to end, keeping its note events if
+ * keep_notes and its tempo changes if not. Returns the number of
+ * note ons. */
+int midi_track(long at, long end, int keep_notes)
+{
+    long tick = 0;
+    int status = 0;
+    int note_ons = 0;
+
+    while (at < end)
+    {
+        int data1, data2, type;
+        long length;
+
+        tick += midi_varlen(&at, end);
+        if (midi_word(at, 1) & 0x80)
+        {
+            status = midi[at++];
+        }
+        if (status == 0xFF)
+        {
+            type = (int)midi_word(at++, 1);
+            length = midi_varlen(&at, end);
+            if (type == 0x51 && length == 3 && !keep_notes && tempo_count < MAX_TEMPOS)
+            {
+                tempos[tempo_count].tick = tick;
+                tempos[tempo_count].us_per_beat = midi_word(at, 3);
+                tempo_count++;
+            }
+            at += length;
+            status = 0;
+            continue;
+        }
+        if (status == 0xF0 || status == 0xF7)
+        {
+            length = midi_varlen(&at, end);
+            at += length;
+            status = 0;
+            continue;
+        }
+        if (status < 0x80)
+        {
+            fail("bad MIDI event", "");
+        }
+        data1 = (int)midi_word(at++, 1);
+        type = status & 0xF0;
+        if (type == 0xC0 || type == 0xD0)
+        {
+            continue;
+        }
+        data2 = (int)midi_word(at++, 1);
+        if (type != 0x80 && type != 0x90)
+        {
+            continue;
+        }
+        if (type == 0x90 && data2 > 0)
+        {
+            note_ons++;
+        }
+        if (keep_notes)
+        {
+            if (event_count == MIDI_MAX_EVENTS)
+            {
+                fail("too many MIDI events", "");
+            }
+            events[event_count].tick = tick;
+            events[event_count].key = data1;
+            events[event_count].on = type == 0x90 && data2 > 0;
+            event_count++;
+        }
+    }
+    return note_ons;
+}
+
+int compare_tempos(const void *a, const void *b)
+{
+    long d = ((const struct tempo *)a)->tick - ((const struct tempo *)b)->tick;
+    return d < 0 ? -1 : d > 0;
+}
+
+/* Milliseconds from the start of the file to tick */
+double tick_ms(long tick)
+{
+    double ms = 0;
+    long last_tick = 0;
+    long us_per_beat = 500000; // 120 beats a minute until told otherwise
+    int i;
+
+    for (i = 0; i < tempo_count && tempos[i].tick < tick; i++)
+    {
+        ms += (double)(tempos[i].tick - last_tick) * us_per_beat / ticks_per_beat / 1000;
+        last_tick = tempos[i].tick;
+        us_per_beat = tempos[i].us_per_beat;
+    }
+    return ms + (double)(tick - last_tick) * us_per_beat / ticks_per_beat / 1000;
+}
+
+void load_midi(const char *name, const char *file, int track)
+{
+    FILE *f = fopen(file, "rb");
+    long at, starts[64], ends[64];
+    int tracks = 0, i, pick = -1;
+    int key = -1;
+    long start = 0;
+    char key_text[8];
+
+    if (!f)
+    {
+        fail("can't open", file);
+    }
+    fseek(f, 0, SEEK_END);
+    midi_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    midi = malloc(midi_size);
+    if (!midi || fread(midi, 1, midi_size, f) != (size_t)midi_size)
+    {
+        fail("can't read", file);
+    }
+    fclose(f);
+    if (midi_size < 14 || memcmp(midi, "MThd", 4) != 0)
+    {
+        fail("not a MIDI file:", file);
+    }
+    ticks_per_beat = midi_word(12, 2);
+    if (ticks_per_beat & 0x8000 || ticks_per_beat == 0)
+    {
+        fail("SMPTE time is not supported:", file);
+    }
+
+    // Find the tracks and the tempo map
+    tempo_count = 0;
+    at = 8 + midi_word(4, 4);
+    while (at + 8 <= midi_size && tracks < 64)
+    {
+        long length = midi_word(at + 4, 4);
+        if (memcmp(midi + at, "MTrk", 4) == 0)
+        {
+            starts[tracks] = at + 8;
+            ends[tracks] = at + 8 + length > midi_size ? midi_size : at + 8 + length;
+            if (midi_track(starts[tracks], ends[tracks], 0) > 0 && pick < 0 && track < 0)
+            {
+                pick = tracks;
+            }
+            tracks++;
+        }
+        at += 8 + length;
+    }
+    if (track >= 0)
+    {
+        pick = track < tracks ? track : -1;
+    }
+    if (pick < 0)
+    {
+        fail("no notes in", file);
+    }
+    qsort(tempos, tempo_count, sizeof(tempos[0]), compare_tempos);
+
+    // One note at a time, gaps become rests
+    event_count = 0;
+    midi_track(starts[pick], ends[pick], 1);
+    start_song(name);
+    for (i = 0; i < event_count; i++)
+    {
+        struct event *e = &events[i];
+        if (!e->on && e->key != key)
+        {
+            continue;
+        }
+        if (e->tick > start || key >= 0)
+        {
+            int ms = (int)floor(tick_ms(e->tick) - tick_ms(start) + 0.5);
+            if (key >= 0)
+            {
+                key_name(key, key_text);
+                add_note(key_hz(key), ms, key_text);
+            }
+            else if (note_count > 0)
+            {
+                add_note(NOTE_REST, ms, "");
+            }
+        }
+        key = e->on ? e->key : -1;
+        start = e->tick;
+    }
+    free(midi);
+    print_song();
+}
+
+/* Score text */
+
+void add_token(char *token, int ms, int *repeat_start)
+{
+    char *scale;
+    int key, hz, length = ms;
+
+    if (strcmp(token, "[") == 0)
+    {
+        if (*repeat_start >= 0)
+        {
+            fail("repeats can't nest", "");
+        }
+        *repeat_start = note_count;
+        return;
+    }
+    if (token[0] == ']')
+    {
+        int times = atoi(token + 1);
+        int back = note_count - *repeat_start;
+        if (*repeat_start < 0)
+        {
+            fail("] without [", "");
+        }
+        if (times < 2 || times > 256 || back < 1 || back > 255)
+        {
+            fail("bad repeat:", token);
+        }
+        if (note_count == MAX_NOTES)
+        {
+            fail("too many notes", "");
+        }
+        notes[note_count].hz = NOTE_REPEAT;
+        notes[note_count].ms = times - 1;
+        notes[note_count].back = back;
+        note_count++;
+        *repeat_start = -1;
+        return;
+    }
+
+    scale = strpbrk(token, "*/");
+    if (scale)
+    {
+        int by = atoi(scale + 1);
+        if (by <= 0)
+        {
+            fail("bad note length:", token);
+        }
+        length = *scale == '*' ? ms * by : ms / by;
+        *scale = 0;
+    }
+    if (strcmp(token, "R") == 0)
+    {
+        add_note(NOTE_REST, length, "");
+        return;
+    }
+    key = parse_key(token);
+    if (key >= 0)
+    {
+        hz = key_hz(key);
+    }
+    else
+    {
+        char *end;
+        hz = (int)strtol(token, &end, 10);
+        if (*end != 0 || end == token)
+        {
+            fail("not a note:", token);
+        }
+    }
+    add_note(hz, length, token);
+}
+
+int main(int argc, char **argv)
+{
+    FILE *f;
+    char line[1024];
+    int ms = 0;
+    int in_song = 0;
+    int repeat_start = -1;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s score.txt > songs.h\n", argv[0]);
+        return 1;
+    }
+    score_file = argv[1];
+    f = fopen(score_file, "r");
+    if (!f)
+    {
+        perror(score_file);
+        return 1;
+    }
+
+    printf("/* Generated by tools/song_table.c from %s, do not edit.\n", score_file);
+    printf(" *\n");
+    printf(" * Every song is a struct note array ending with {0, 0}, see\n");
+    printf(" * audio_link.h for the entry types.\n");
+    printf(" */\n\n");
+
+    while (fgets(line, sizeof(line), f))
+    {
+        char *token, *comment = strchr(line, '#');
+        line_number++;
+        if (comment)
+        {
+            *comment = 0;
+        }
+        token = strtok(line, " \t\r\n");
+        if (!token)
+        {
+            continue;
+        }
+        if (strcmp(token, "song") == 0 || strcmp(token, "midi") == 0)
+        {
+            char *name = strtok(0, " \t\r\n");
+            char *arg = strtok(0, " \t\r\n");
+            char *track = strtok(0, " \t\r\n");
+            if (repeat_start >= 0)
+            {
+                fail("[ without ]", "");
+            }
+            if (in_song)
+            {
+                print_song();
+                in_song = 0;
+            }
+            if (!name || !arg)
+            {
+                fail("missing name or argument", "");
+            }
+            if (token[0] == 'm')
+            {
+                load_midi(name, arg, track ? atoi(track) : -1);
+                continue;
+            }
+            start_song(name);
+            ms = atoi(arg);
+            in_song = 1;
+            continue;
+        }
+        if (!in_song)
+        {
+            fail("notes outside a song:", token);
+        }
+        if (strcmp(token, "tempo") == 0)
+        {
+            char *arg = strtok(0, " \t\r\n");
+            ms = arg ? atoi(arg) : 0;
+            continue;
+        }
+        for (; token; token = strtok(0, " \t\r\n"))
+        {
+            add_token(token, ms, &repeat_start);
+        }
+    }
+    fclose(f);
+    if (repeat_start >= 0)
+    {
+        fail("[ without ]", "");
+    }
+    if (in_song)
+    {
+        print_song();
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/* telemetry_decode.c
+ * Host tool that decodes the telemetry stream of a TELEMETRY build
+ * (see send_telemetry in main.c) into CSV.
+ *
+ *   gcc -o telemetry_decode tools/telemetry_decode.c
+ *   stty -F /dev/ttyACM1 9600 raw
+ *   ./telemetry_decode < /dev/ttyACM1 > run.csv
+ *
+ * CSV goes to stdout, one line per record. Every 64 records a line
+ * of running statistics goes to stderr: records, dropped frames,
+ * bad checksums, and frame cycles / SPI bytes (min, mean, max).
+ */
+#include <stdio.h>
+
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_RECORD_SIZE 16
+
+struct stat
+{
+    long count;
+    unsigned int min;
+    unsigned int max;
+    double total;
+};
+
+void add_stat(struct stat *stat, unsigned int value)
+{
+    if (stat->count == 0 || value < stat->min)
+        stat->min = value;
+    if (value > stat->max)
+        stat->max = value;
+    stat->total += value;
+    stat->count++;
+}
+
+double mean(struct stat *stat)
+{
+    return stat->count ? stat->total / stat->count : 0;
+}
+
+int main(void)
+{
+    unsigned char record[TELEMETRY_RECORD_SIZE];
+    struct stat cycles = {0}, spi = {0};
+    long records = 0, dropped = 0, bad = 0;
+    int have = 0, last_frame = -1, c, i;
+
+    printf("frame,ball_x,ball_y,ball_x_vel,ball_y_vel,player_y,computer_y,"
+           "player_score,computer_score,ai_move,ai_select,frame_cycles,spi_bytes\n");
+
+    while ((c = getchar()) != EOF)
+    {
+        unsigned char sum = 0;
+
+        if (have == 0 && c != TELEMETRY_SYNC)
+            continue;
+        record[have++] = c;
+        if (have < TELEMETRY_RECORD_SIZE)
+            continue;
+
+        for (i = 1; i < TELEMETRY_RECORD_SIZE - 1; i++)
+            sum += record[i];
+        if (sum != record[TELEMETRY_RECORD_SIZE - 1])
+        {
+            // Lost sync, look for the next sync byte inside this record
+            bad++;
+            for (i = 1; i < TELEMETRY_RECORD_SIZE && record[i] != TELEMETRY_SYNC; i++)
+                ;
+            have = TELEMETRY_RECORD_SIZE - i;
+            for (c = 0; c < have; c++)
+                record[c] = record[i + c];
+            continue;
+        }
+        have = 0;
+
+        if (last_frame >= 0)
+            dropped += (unsigned char)(record[1] - last_frame - 1);
+        last_frame = record[1];
+        records++;
+
+        unsigned int frame_cycles = record[10] | (record[11] << 8);
+        unsigned int spi_bytes = record[12] | (record[13] << 8);
+        add_stat(&cycles, frame_cycles);
+        add_stat(&spi, spi_bytes);
+
+        printf("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%u,%u\n",
+               record[1], (signed char)record[2], (signed char)record[3],
+               (signed char)record[4], (signed char)record[5],
+               (signed char)record[6], (signed char)record[7],
+               record[8] >> 4, record[8] & 0x0F, (signed char)record[9],
+               record[14], frame_cycles, spi_bytes);
+
+        if (records % 64 == 0)
+        {
+            fflush(stdout);
+            fprintf(stderr, "records %ld dropped %ld bad %ld | cycles %u/%.0f/%u | spi %u/%.0f/%u\n",
+                    records, dropped, bad, cycles.min, mean(&cycles), cycles.max,
+                    spi.min, mean(&spi), spi.max);
+        }
+    }
+
+    fprintf(stderr, "records %ld dropped %ld bad %ld | cycles %u/%.0f/%u | spi %u/%.0f/%u\n",
+            records, dropped, bad, cycles.min, mean(&cycles), cycles.max,
+            spi.min, mean(&spi), spi.max);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/* title_image.c
+ * Host tool that generates title_image.h, the title screen as the
+ * panel RAM holds it, which the FAST_BOOT build of main.c sends in one
+ * pass (draw_image) instead of clearing the panel and drawing the
+ * strings glyph by glyph.
+ *
+ *   gcc -I. -o title_image tools/title_image.c
+ *   ./title_image > title_image.h
+ *
+ * The strings and their places are the ones draw_title() draws the title
+ * with, rendered the way draw_string() does: font_8x8 glyphs are one
+ * page high, a byte per column, cut off at the last column.
+ */
+#include <stdio.h>
+#include <font_8x8.h>
+
+#define COLUMNS 102
+#define PAGES 8
+
+struct title_string
+{
+    int column;
+    int page;
+    const char *text;
+};
+
+// Same as draw_title() in main.c
+const struct title_string title[] = {
+    {35, 1, "PONG"},
+    {10, 3, "FIRST TO 5"},
+    {35, 4, "WINS!"},
+    {3, 5, "Press: STATS"},
+    {20, 6, "Twist to"},
+    {32, 7, "START"},
+};
+
+unsigned char image[PAGES][COLUMNS];
+
+/* Same as draw_string() in main.c, into image */
+void draw_string(int column, int page, const unsigned char *font, const char *str)
+{
+    int first = font[2], last = font[3], width = font[4], bytes = font[7];
+    int x;
+
+    for (; *str != '\0'; str++)
+    {
+        if ((unsigned char)*str < first || (unsigned char)*str > last)
+        {
+            continue;
+        }
+        for (x = 0; x < width && column + x < COLUMNS; x++)
+        {
+            image[page][column + x] = font[8 + ((unsigned char)*str - first) * bytes + x];
+        }
+        column += width;
+    }
+}
+
+int main(void)
+{
+    int i, page, x;
+
+    for (i = 0; i < (int)(sizeof(title) / sizeof(title[0])); i++)
+    {
+        draw_string(title[i].column, title[i].page, font_8x8, title[i].text);
+    }
+
+    printf("/* Generated by tools/title_image.c, do not edit.\n");
+    printf(" *\n");
+    printf(" * The title screen, title_image[page][column] being the byte the\n");
+    printf(" * panel RAM holds there (bit 0 the top row of the page).\n");
+    printf(" */\n\n");
+    printf("const unsigned char title_image[%d][%d] = {\n", PAGES, COLUMNS);
+    for (page = 0; page < PAGES; page++)
+    {
+        printf("    {");
+        for (x = 0; x < COLUMNS; x++)
+        {
+            if (x % 17 == 0)
+            {
+                printf("\n        ");
+            }
+            printf("0x%02X,", image[page][x]);
+            if (x % 17 != 16)
+            {
+                printf(" ");
+            }
+        }
+        printf("\n    },\n");
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+/* verify_intercept.c
+ * Host tool that checks intercept_table.h against a brute-force
+ * simulation of move_ball() and the hit zones of collides().
+ *
+ *   gcc -o verify_intercept tools/verify_intercept.c
+ *   ./verify_intercept
+ *
+ * Every ball y/y_vel that can leave a paddle is flown towards both
+ * paddles at every x speed and start column, and the table lookup is
+ * checked on every frame of the flight. Exits non-zero on a mismatch.
+ */
+#include <stdio.h>
+#include "../intercept_table.h"
+
+#define BALL_SIZE 4
+#define PLAYER_X 10
+#define COMPUTER_X 85
+#define PADDLE_WIDTH 7
+
+struct ball
+{
+    int x;
+    int y;
+    int x_vel;
+    int y_vel;
+};
+
+/* Copy of move_ball() in main.c */
+void move_ball(struct ball *ball)
+{
+    if (ball->y <= 0 || ball->y >= 59)
+    {
+        ball->y_vel = -ball->y_vel;
+    }
+
+    ball->x += ball->x_vel;
+    ball->y += ball->y_vel;
+}
+
+/* x part of collides() in main.c */
+int in_hit_zone(struct ball *ball)
+{
+    if (ball->x_vel > 0)
+    {
+        return ball->x + BALL_SIZE > COMPUTER_X;
+    }
+    return ball->x < PLAYER_X + PADDLE_WIDTH;
+}
+
+/* Same table walk as intercept_lookup() in main.c */
+int lookup(int y, int y_vel, int frames)
+{
+    int mirror = 0;
+    unsigned int start;
+
+    if (y_vel == 0)
+    {
+        return y;
+    }
+    if (y_vel < 0)
+    {
+        y = INTERCEPT_SPAN - y;
+        y_vel = -y_vel;
+        mirror = 1;
+    }
+    if (y_vel > INTERCEPT_MAX_Y_SPEED || y < INTERCEPT_Y_MIN || y > INTERCEPT_Y_MAX)
+    {
+        return -1000;
+    }
+    start = intercept_start[y_vel - 1][y - INTERCEPT_Y_MIN];
+    if (start & INTERCEPT_TWO_CYCLE)
+    {
+        y = intercept_path[(start & ~INTERCEPT_TWO_CYCLE) + (frames & 1)];
+    }
+    else
+    {
+        y = intercept_path[start + frames];
+    }
+    return mirror ? INTERCEPT_SPAN - y : y;
+}
+
+int main(void)
+{
+    int y, y_vel, speed, dir, x;
+    long checked = 0, failed = 0;
+
+    for (dir = -1; dir <= 1; dir += 2)
+    {
+        for (speed = 1; speed <= INTERCEPT_MAX_X_SPEED; speed++)
+        {
+            for (x = PLAYER_X + PADDLE_WIDTH; x <= COMPUTER_X - BALL_SIZE; x++)
+            {
+                for (y_vel = -INTERCEPT_MAX_Y_SPEED; y_vel <= INTERCEPT_MAX_Y_SPEED; y_vel++)
+                {
+                    for (y = -5; y <= 64; y++)
+                    {
+                        struct ball start = {x, y, dir * speed, y_vel};
+                        struct ball ball = start;
+                        int frames = 0, dist, step;
+
+                        dist = dir > 0 ? COMPUTER_X - BALL_SIZE + 1 - x : x - (PLAYER_X + PADDLE_WIDTH - 1);
+                        if (dist <= 0 || dist > INTERCEPT_MAX_DIST)
+                        {
+                            continue;
+                        }
+
+                        while (!in_hit_zone(&ball))
+                        {
+                            move_ball(&ball);
+                            frames++;
+                        }
+                        if (frames != intercept_frames[speed - 1][dist])
+                        {
+                            printf("frames: x=%d speed=%d got %d want %d\n",
+                                   x, dir * speed, intercept_frames[speed - 1][dist], frames);
+                            failed++;
+                        }
+
+                        // Check the prediction from every frame of the flight
+                        ball = start;
+                        for (step = 0; step < frames; step++)
+                        {
+                            int predicted = lookup(ball.y, ball.y_vel, frames - step);
+                            int actual;
+                            struct ball fly = ball;
+                            while (!in_hit_zone(&fly))
+                            {
+                                move_ball(&fly);
+                            }
+                            actual = fly.y;
+                            checked++;
+                            if (predicted != actual)
+                            {
+                                printf("y: x=%d y=%d vel=(%d,%d) frames=%d got %d want %d\n",
+                                       ball.x, ball.y, ball.x_vel, ball.y_vel, frames - step, predicted, actual);
+                                failed++;
+                            }
+                            move_ball(&ball);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%ld lookups checked, %ld failed\n", checked, failed);
+    return failed != 0;
+}
@@ -0,0 +1,202 @@
+/* wav_clip.c
+ * Host tool that generates clips.h, the 8-bit 8kHz sound clips the
+ * audio MCU streams into its PWM by DMA (see play_clip() in music.c),
+ * from WAV files.
+ *
+ *   gcc -o wav_clip tools/wav_clip.c
+ *   ./wav_clip -n hit tools/clips/hit.wav -n score tools/clips/score.wav > clips.h
+ *
+ *   -n             before a name: scale that clip up to full volume
+ *
+ * Takes 8 or 16-bit PCM at any rate, mixes the channels and resamples
+ * to CLIP_RATE by averaging the input over every output sample. Each
+ * clip becomes <name>_clip[<NAME>_CLIP_LENGTH], unsigned samples that
+ * are the PWM duty out of 256 (128 is silence).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define CLIP_RATE 8000
+#define MAX_SAMPLES 65535 // DMAxSZ
+
+unsigned char *wav;
+long wav_size;
+
+long read_le(const unsigned char *at, int bytes)
+{
+    long value = 0;
+    while (bytes--)
+    {
+        value = (value << 8) | at[bytes];
+    }
+    return value;
+}
+
+void fail(const char *file, const char *message)
+{
+    fprintf(stderr, "%s: %s\n", file, message);
+    exit(1);
+}
+
+/* Loads file and returns its samples mixed to mono, -1..1 */
+double *load_wav(const char *file, long *count, long *rate)
+{
+    FILE *f = fopen(file, "rb");
+    long at = 12, data = -1, data_size = 0;
+    int channels = 0, bits = 0;
+    double *samples;
+    long i;
+
+    if (!f)
+    {
+        fail(file, "can't open");
+    }
+    fseek(f, 0, SEEK_END);
+    wav_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    wav = malloc(wav_size);
+    if (!wav || fread(wav, 1, wav_size, f) != (size_t)wav_size)
+    {
+        fail(file, "can't read");
+    }
+    fclose(f);
+    if (wav_size < 12 || memcmp(wav, "RIFF", 4) != 0 || memcmp(wav + 8, "WAVE", 4) != 0)
+    {
+        fail(file, "not a WAV file");
+    }
+
+    while (at + 8 <= wav_size)
+    {
+        long size = read_le(wav + at + 4, 4);
+        if (memcmp(wav + at, "fmt ", 4) == 0 && size >= 16)
+        {
+            if (read_le(wav + at + 8, 2) != 1)
+            {
+                fail(file, "only PCM is supported");
+            }
+            channels = (int)read_le(wav + at + 10, 2);
+            *rate = read_le(wav + at + 12, 4);
+            bits = (int)read_le(wav + at + 22, 2);
+        }
+        else if (memcmp(wav + at, "data", 4) == 0)
+        {
+            data = at + 8;
+            data_size = size > wav_size - data ? wav_size - data : size;
+        }
+        at += 8 + size + (size & 1);
+    }
+    if (data < 0 || channels < 1 || *rate < 1 || (bits != 8 && bits != 16))
+    {
+        fail(file, "needs 8 or 16-bit PCM data");
+    }
+
+    *count = data_size / (channels * bits / 8);
+    samples = malloc(sizeof(double) * (*count + 1));
+    for (i = 0; i < *count; i++)
+    {
+        double sum = 0;
+        int c;
+        for (c = 0; c < channels; c++)
+        {
+            const unsigned char *s = wav + data + (i * channels + c) * (bits / 8);
+            sum += bits == 8 ? (*s - 128) / 128.0 : (short)read_le(s, 2) / 32768.0;
+        }
+        samples[i] = sum / channels;
+    }
+    free(wav);
+    return samples;
+}
+
+void print_clip(const char *name, const char *file, int normalize)
+{
+    long count, rate, length, i, j;
+    double *in = load_wav(file, &count, &rate);
+    double *out, peak = 0, gain = 1;
+    double per_sample = (double)rate / CLIP_RATE;
+    char upper[64];
+
+    length = (long)(count / per_sample);
+    if (length > MAX_SAMPLES)
+    {
+        fail(file, "longer than a DMA block can take");
+    }
+    out = malloc(sizeof(double) * (length + 1));
+    for (i = 0; i < length; i++)
+    {
+        // Average of the input under the output sample
+        double from = i * per_sample, to = from + per_sample, sum = 0;
+        for (j = (long)from; j < to && j < count; j++)
+        {
+            double left = j < from ? from : j;
+            double right = j + 1 > to ? to : j + 1;
+            sum += in[j] * (right - left);
+        }
+        out[i] = sum / per_sample;
+        if (out[i] > peak || -out[i] > peak)
+        {
+            peak = out[i] > 0 ? out[i] : -out[i];
+        }
+    }
+    if (normalize && peak > 0)
+    {
+        gain = 1 / peak;
+    }
+
+    for (i = 0; name[i] && i < (long)sizeof(upper) - 1; i++)
+    {
+        upper[i] = toupper((unsigned char)name[i]);
+    }
+    upper[i] = 0;
+    printf("// %s, %ld samples (%ld ms)\n", file, length, length * 1000 / CLIP_RATE);
+    printf("#define %s_CLIP_LENGTH %ld\n", upper, length);
+    printf("const unsigned char %s_clip[%s_CLIP_LENGTH] =\n{", name, upper);
+    for (i = 0; i < length; i++)
+    {
+        long value = (long)(out[i] * gain * 127.5 + 128);
+        if (value < 0)
+            value = 0;
+        if (value > 255)
+            value = 255;
+        if (i % 16 == 0)
+            printf("\n   ");
+        printf("%4ld,", value);
+    }
+    printf("\n};\n\n");
+    free(in);
+    free(out);
+}
+
+int main(int argc, char **argv)
+{
+    int i, normalize = 0;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s [-n] name file.wav ... > clips.h\n", argv[0]);
+        return 1;
+    }
+    printf("/* Generated by tools/wav_clip.c, do not edit.\n");
+    printf(" *\n");
+    printf(" * Unsigned 8-bit samples at CLIP_RATE, the PWM duty out of 256.\n");
+    printf(" */\n\n");
+    printf("#define CLIP_RATE %d\n\n", CLIP_RATE);
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0)
+        {
+            normalize = 1;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "%s has no file\n", argv[i]);
+            return 1;
+        }
+        print_clip(argv[i], argv[i + 1], normalize);
+        normalize = 0;
+        i++;
+    }
+    return 0;
+}